@@ -0,0 +1,82 @@
+/**
+ * Angle Estimator Benchmark
+ *
+ * Measures the cycle cost of FlameTriangulation's angle estimators on the
+ * target: the least-squares fit behind getFlameAngle and the former
+ * piecewise estimators. Accuracy against ground truth is measured on the host
+ * (tools/estimator_bench); this sketch supplies the cycles per estimate.
+ *
+ * Timer1 runs at the CPU clock (no prescaler) so TCNT1 counts cycles
+ * directly. ITERATIONS is kept small so the 16-bit counter cannot wrap
+ * (the least-squares fit scores every bearing table entry and costs on the
+ * order of ten thousand cycles).
+ */
+
+#include <Arduino.h>
+#include "../include/FlameTriangulation.h"
+
+#define ITERATIONS 4
+
+DetectionSettings detection = { DEFAULT_NOISE_MULTIPLIER, DEFAULT_FIXED_THRESHOLD };
+FlameTriangulation flameSensor(detection);
+
+volatile float sink;
+
+void startTimer() {
+  noInterrupts();
+  TCNT1 = 0;
+}
+
+uint16_t stopTimer() {
+  uint16_t cycles = TCNT1;
+  interrupts();
+  return cycles;
+}
+
+void report(const __FlashStringHelper* label, uint16_t cycles, uint16_t overhead) {
+  Serial.print(label);
+  Serial.print(F(": "));
+  Serial.print((float)(cycles - overhead) / ITERATIONS, 1);
+  Serial.println(F(" cycles/estimate"));
+}
+
+void setup() {
+  Serial.begin(9600);
+
+  // A flame slightly right of centre seen by all three sensors
+  int ambient = 900 << ADC_OVERSAMPLE_BITS;
+  flameSensor.calibrate(ambient, ambient, ambient);
+  for (int i = 0; i < 5; i++) {
+    flameSensor.updateReadings(ambient - (300 << ADC_OVERSAMPLE_BITS),
+                               ambient - (200 << ADC_OVERSAMPLE_BITS),
+                               ambient - (280 << ADC_OVERSAMPLE_BITS));
+  }
+
+  TCCR1A = 0;
+  TCCR1B = 1; // clk/1
+  TIMSK1 = 0;
+
+  uint16_t overhead, cycles;
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { asm volatile(""); }
+  overhead = stopTimer();
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { sink = flameSensor.weightedAngularTriangulation(); }
+  cycles = stopTimer();
+  report(F("weightedAngularTriangulation"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { sink = flameSensor.dualSensorEstimation(); }
+  cycles = stopTimer();
+  report(F("dualSensorEstimation"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { sink = flameSensor.getFlameAngle(); }
+  cycles = stopTimer();
+  report(F("getFlameAngle"), cycles, overhead);
+}
+
+void loop() {
+}
@@ -0,0 +1,114 @@
+/**
+ * FastPin Benchmark
+ *
+ * Compares the cost of digitalWrite()/digitalRead() against the
+ * compile-time FastPin<PIN> accessors used by the pump relay, siren LEDs,
+ * status LED and calibration button.
+ *
+ * It also times the output writes the idle loop made on every pass
+ * before the event bus: both siren LEDs written low and noTone() on the
+ * buzzer. The idle loop now makes none, so that figure is the saving per
+ * pass.
+ *
+ * Timer1 runs at the CPU clock (no prescaler) so TCNT1 counts cycles
+ * directly. Each operation is repeated ITERATIONS times and the cost of
+ * the empty loop is subtracted. Do not attach a servo while this runs;
+ * the Servo library also uses Timer1.
+ */
+
+#include <Arduino.h>
+#include "../include/FastPin.h"
+
+#define TEST_OUTPUT_PIN 6   // Pump relay pin
+#define TEST_INPUT_PIN 2    // Calibration button pin
+#define SIREN_PIN_1 4       // Siren LED pins
+#define SIREN_PIN_2 5
+#define BUZZER_TEST_PIN 7   // Buzzer pin
+#define ITERATIONS 100
+#define IDLE_LOOPS_PER_SECOND 20  // 50 ms loop delay without flame
+
+typedef FastPin<TEST_OUTPUT_PIN> OutPin;
+typedef FastPin<TEST_INPUT_PIN> InPin;
+
+volatile uint8_t sink;
+
+void startTimer() {
+  noInterrupts();
+  TCNT1 = 0;
+}
+
+uint16_t stopTimer() {
+  uint16_t cycles = TCNT1;
+  interrupts();
+  return cycles;
+}
+
+void report(const __FlashStringHelper* label, uint16_t cycles, uint16_t overhead) {
+  Serial.print(label);
+  Serial.print(F(": "));
+  Serial.print((float)(cycles - overhead) / ITERATIONS, 1);
+  Serial.println(F(" cycles/call"));
+}
+
+void setup() {
+  Serial.begin(9600);
+  pinMode(TEST_OUTPUT_PIN, OUTPUT);
+  pinMode(TEST_INPUT_PIN, INPUT_PULLUP);
+  pinMode(SIREN_PIN_1, OUTPUT);
+  pinMode(SIREN_PIN_2, OUTPUT);
+  pinMode(BUZZER_TEST_PIN, OUTPUT);
+
+  TCCR1A = 0;
+  TCCR1B = 1; // clk/1
+  TIMSK1 = 0;
+
+  uint16_t overhead, cycles;
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { asm volatile(""); }
+  overhead = stopTimer();
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { digitalWrite(TEST_OUTPUT_PIN, i & 1); }
+  cycles = stopTimer();
+  report(F("digitalWrite"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { OutPin::write(i & 1); }
+  cycles = stopTimer();
+  report(F("FastPin::write"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { OutPin::high(); asm volatile(""); }
+  cycles = stopTimer();
+  report(F("FastPin::high"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { sink = digitalRead(TEST_INPUT_PIN); }
+  cycles = stopTimer();
+  report(F("digitalRead"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) { sink = InPin::read(); }
+  cycles = stopTimer();
+  report(F("FastPin::read"), cycles, overhead);
+
+  startTimer();
+  for (uint8_t i = 0; i < ITERATIONS; i++) {
+    digitalWrite(SIREN_PIN_1, LOW);
+    digitalWrite(SIREN_PIN_2, LOW);
+    noTone(BUZZER_TEST_PIN);
+  }
+  cycles = stopTimer();
+  report(F("Idle outputs before the event bus, per loop"), cycles, overhead);
+  Serial.print(F("Saved per second at "));
+  Serial.print(IDLE_LOOPS_PER_SECOND);
+  Serial.print(F(" idle loops/s: "));
+  Serial.print((float)(cycles - overhead) / ITERATIONS * IDLE_LOOPS_PER_SECOND / (F_CPU / 1000000UL), 1);
+  Serial.println(F(" us"));
+
+  OutPin::high(); // Leave the relay off (active low)
+}
+
+void loop() {
+}
@@ -9,8 +9,6 @@
  */
 
 #include <Servo.h>
-#include <Wire.h>
-#include <LiquidCrystal_I2C.h>
 #include "../include/LCD.h" // Using the project's LCD implementation
 
 // Pin definitions
@@ -54,6 +52,7 @@ void setup() {
   // Initialize LCD
   initializeLCD();
   showStartupMessage();
+  delay(2000);
   
   // Initial display update
   updateSystemStatus();
@@ -0,0 +1,82 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include "RawCapture.h"
+
+// Oversampling and decimation: summing 4^n conversions and shifting right
+// by n adds n bits of resolution (the sensor noise acts as dither).
+#ifndef ADC_OVERSAMPLE_BITS
+#define ADC_OVERSAMPLE_BITS 2                                   // 2 -> 12-bit, 3 -> 13-bit
+#endif
+#define ADC_OVERSAMPLE_COUNT (1 << (2 * ADC_OVERSAMPLE_BITS))   // Conversions per channel per output
+#define ADC_SAMPLE_BITS (10 + ADC_OVERSAMPLE_BITS)
+#define ADC_SAMPLE_MAX ((1 << ADC_SAMPLE_BITS) - 1)
+
+#if ADC_OVERSAMPLE_BITS > 3
+#error "ADC_OVERSAMPLE_BITS > 3 overflows the 16-bit accumulators"
+#endif
+
+// ADC clock prescaler (ADPS bits): 7 = /128 (125 kHz), 6 = /64 (250 kHz).
+// Output rate = F_CPU / prescaler / 13 / 3 channels / ADC_OVERSAMPLE_COUNT:
+//   /128: 12-bit ~200 Hz, 13-bit ~50 Hz
+//   /64:  12-bit ~400 Hz, 13-bit ~100 Hz
+#define ADC_PRESCALER_BITS 7
+
+#define ADC_SAMPLER_CHANNELS 3
+
+// One decimated frame and when each channel was captured: the low 16
+// bits of micros() halfway between the starts of the channel's first and
+// last conversion in the frame. The channels are converted in turn, so
+// their stamps differ by a conversion time and the interrupt latency.
+// The frame before it comes along, kept by the interrupt, so a reader
+// that misses frames still gets the one that directly preceded this one.
+// The stamps wrap every 65.5 ms, but the two frames are 5 ms apart.
+struct SampleTriple {
+    int reading[ADC_SAMPLER_CHANNELS];
+    uint16_t stamp[ADC_SAMPLER_CHANNELS];
+    int previous[ADC_SAMPLER_CHANNELS];
+    uint16_t previousStamp[ADC_SAMPLER_CHANNELS];
+    bool hasPrevious;                        // False for the first frame after begin()
+};
+
+// Interrupt-driven round-robin sampler producing decimated sample triples.
+// analogRead() must not be used while the sampler is running.
+class AdcSampler {
+public:
+    AdcSampler();
+    void begin(uint8_t pin1, uint8_t pin2, uint8_t pin3);
+    void stop();
+    bool isRunning() const;
+    bool available() const;
+    void read(int& reading1, int& reading2, int& reading3);
+    void read(SampleTriple& triple);
+    void waitForFrame(int& reading1, int& reading2, int& reading3);
+    // Hand every CAPTURE_DECIMATION-th pass of raw conversions to capture
+    // (nullptr detaches)
+    void attachCapture(RawCapture* capture);
+    // Called from the ADC conversion complete interrupt
+    void handleConversion(uint16_t value);
+private:
+    uint8_t channels[ADC_SAMPLER_CHANNELS];
+    volatile uint16_t sums[ADC_SAMPLER_CHANNELS];
+    volatile uint16_t frame[ADC_SAMPLER_CHANNELS];
+    volatile uint16_t frameStamps[ADC_SAMPLER_CHANNELS];
+    volatile uint16_t previousFrame[ADC_SAMPLER_CHANNELS];
+    volatile uint16_t previousStamps[ADC_SAMPLER_CHANNELS];
+    volatile bool hasFrame;                  // frame holds one since begin()
+    volatile bool hasPrevious;               // previousFrame does too
+    uint16_t stamps[ADC_SAMPLER_CHANNELS];   // First conversion's start, then the frame's stamp
+    volatile uint8_t currentChannel;
+    volatile uint8_t sampleCount;
+    volatile bool frameReady;
+    volatile bool running;
+    RawCapture* volatile capture;
+    uint16_t raw[ADC_SAMPLER_CHANNELS];
+    uint8_t captureDivider;
+    void startConversion();
+};
+
+extern AdcSampler adcSampler;
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,80 @@
+#ifndef BACKGROUND_MAP_H
+#define BACKGROUND_MAP_H
+
+#include <Arduino.h>
+#include "FlameTriangulation.h"
+#include "ServoControl.h"
+
+// Per-heading background of each sensor, relative to the calibrated
+// baseline. Windows, heaters and lamps sit at fixed bearings, so as the
+// head sweeps they move the readings by heading; FlameTriangulation
+// subtracts the offsets of the current heading's bin from every reading.
+//
+// The map lives in EEPROM behind the settings (one signed byte per bin
+// and channel), so it survives a restart and takes no RAM beyond the
+// offsets of the bin in use. It is learned two ways:
+//   - survey: the calibration sweep stores every bin outright, which
+//     masks sources strong enough to trigger detection
+//   - quiet sweeps: a pass through a bin without detection moves it one
+//     step towards what it saw, and only past a deadband so EEPROM is
+//     written only when the background really changed
+// The header also keeps the last bearing water was sprayed at, the first
+// place the head searches after a restart or when the flame is lost, and
+// the baseline of the last full calibration, which a restart checks its
+// first frames against.
+#define BACKGROUND_EEPROM_ADDRESS 96     // After the settings block, with room to grow
+#define BACKGROUND_MAGIC 0x4248
+#define BACKGROUND_BIN_DEGREES 2         // About two frames per bin and pass while scanning
+#define BACKGROUND_BINS ((SCAN_MAX_ANGLE - SCAN_MIN_ANGLE) / BACKGROUND_BIN_DEGREES + 1)
+#define BACKGROUND_UNIT_SHIFT (2 + ADC_OVERSAMPLE_BITS)  // Stored offsets are in 4 10-bit counts
+#define BACKGROUND_HEADER_SIZE 10        // BackgroundHeader, in front of the bins
+#define BACKGROUND_EEPROM_END (BACKGROUND_EEPROM_ADDRESS + BACKGROUND_HEADER_SIZE + BACKGROUND_BINS * SENSOR_COUNT)
+
+// Quiet-sweep learning
+#define BACKGROUND_LEARN_FRAMES 2        // Quiet frames needed in one pass to judge a bin
+#define BACKGROUND_LEARN_DEADBAND 6      // Residual that moves a bin one unit (10-bit counts)
+#define BACKGROUND_LEARN_LIMIT DRIFT_WARNING_COUNTS  // Quiet learning grows a bin no further (10-bit counts)
+
+// Calibration survey
+#define BACKGROUND_SURVEY_FRAMES 8       // Frames averaged per bin
+#define BACKGROUND_SURVEY_SETTLE 60      // Servo settle time per bin (ms)
+
+// Reacquisition around the last fire bearing
+#define REACQUIRE_WINDOW 15              // Degrees either side of the bearing
+#define REACQUIRE_LEGS 2                 // Sweeps across the window before the full scan resumes
+
+#define NO_FIRE_BEARING 0xFF
+#define NO_BASELINE -1
+
+class BackgroundMap {
+public:
+    BackgroundMap();
+    bool load();                         // false, and an empty map, if EEPROM holds none
+    void clear();
+    // Hands the offsets of heading's bin to the estimator, before each frame
+    void apply(int heading, FlameTriangulation& flameSensor);
+    // After each frame while the head scans
+    void learn(int heading, FlameTriangulation& flameSensor);
+    // Survey result for one bin, in sample counts
+    void store(uint8_t bin, const int offsets[]);
+    static int binHeading(uint8_t bin);
+    // Fire bearing: noted while water flows, written when the flame is lost
+    void noteFire(int heading);
+    void saveFire();
+    int getFireBearing() const;          // -1 if none
+    // Baseline of the last fine or manual calibration (background removed)
+    void saveBaseline(const int levels[]);
+    bool getBaseline(int levels[]) const;  // false if none was saved
+private:
+    uint8_t appliedBin;
+    uint8_t learnBin;
+    int8_t learnFrames;                  // -1: the pass saw a detection
+    int learnSums[SENSOR_COUNT];
+    uint8_t fireBearing;
+    bool firePending;
+    static uint8_t binOf(int heading);
+    static int address(uint8_t bin, uint8_t channel);
+    void commitLearning(FlameTriangulation& flameSensor);
+};
+
+#endif // BACKGROUND_MAP_H
@@ -0,0 +1,58 @@
+// Generated by tools/bearing_table.cpp from tools/sensor_model.cpp - do not edit.
+// Unit response vectors (Q15, firmware channel order: right, left, middle)
+// of the three sensors to a flame at BEARING_NOMINAL_DISTANCE, by bearing.
+#ifndef BEARING_TABLE_H
+#define BEARING_TABLE_H
+
+#include <Arduino.h>
+
+#define BEARING_TABLE_MIN -40
+#define BEARING_TABLE_STEP 2
+#define BEARING_TABLE_SIZE 41
+#define BEARING_NOMINAL_DISTANCE 60
+
+static const int16_t BEARING_TABLE[BEARING_TABLE_SIZE][3] PROGMEM = {
+    {     0,     0,     0 },  // -40 deg
+    {     0,     0,     0 },  // -38 deg
+    {     0,     0,     0 },  // -36 deg
+    {     0, 32767,     0 },  // -34 deg
+    {     0, 32767,     0 },  // -32 deg
+    {     0, 32767,     0 },  // -30 deg
+    {     0, 31418,  9304 },  // -28 deg
+    {     0, 29839, 13539 },  // -26 deg
+    {  4437, 28384, 15758 },  // -24 deg
+    {  7541, 26998, 16968 },  // -22 deg
+    {  9696, 25811, 17704 },  // -20 deg
+    { 11306, 24797, 18192 },  // -18 deg
+    { 12581, 23914, 18535 },  // -16 deg
+    { 13639, 23124, 18786 },  // -14 deg
+    { 14552, 22402, 18975 },  // -12 deg
+    { 15363, 21729, 19119 },  // -10 deg
+    { 16101, 21089, 19227 },  // -8 deg
+    { 16789, 20472, 19306 },  // -6 deg
+    { 17439, 19869, 19360 },  // -4 deg
+    { 18063, 19271, 19391 },  // -2 deg
+    { 18672, 18672, 19402 },  // +0 deg
+    { 19271, 18063, 19391 },  // +2 deg
+    { 19869, 17439, 19360 },  // +4 deg
+    { 20472, 16789, 19306 },  // +6 deg
+    { 21089, 16101, 19227 },  // +8 deg
+    { 21729, 15363, 19119 },  // +10 deg
+    { 22402, 14552, 18975 },  // +12 deg
+    { 23124, 13639, 18786 },  // +14 deg
+    { 23914, 12581, 18535 },  // +16 deg
+    { 24797, 11306, 18192 },  // +18 deg
+    { 25811,  9696, 17704 },  // +20 deg
+    { 26998,  7541, 16968 },  // +22 deg
+    { 28384,  4437, 15758 },  // +24 deg
+    { 29839,     0, 13539 },  // +26 deg
+    { 31418,     0,  9304 },  // +28 deg
+    { 32767,     0,     0 },  // +30 deg
+    { 32767,     0,     0 },  // +32 deg
+    { 32767,     0,     0 },  // +34 deg
+    {     0,     0,     0 },  // +36 deg
+    {     0,     0,     0 },  // +38 deg
+    {     0,     0,     0 },  // +40 deg
+};
+
+#endif // BEARING_TABLE_H
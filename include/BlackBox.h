@@ -0,0 +1,62 @@
+#ifndef BLACK_BOX_H
+#define BLACK_BOX_H
+
+#include <Arduino.h>
+#include "EventBus.h"
+#include "FlameTriangulation.h"
+
+// Ring of recent compact frames, frozen around the first flame detection.
+// Sized to the static RAM left under custom_ram_budget in platformio.ini
+// (48 x 6 bytes). To resize it, set it in build_flags and read the
+// headroom from `pio run -e uno -e uno_fixed -e uno_capture -t memreport`.
+#ifndef BLACKBOX_FRAMES
+#define BLACKBOX_FRAMES 48
+#endif
+#if BLACKBOX_FRAMES > 255
+#error "BLACKBOX_FRAMES must fit the uint8_t ring indices"
+#endif
+#define BLACKBOX_INTERVAL 50      // ms between recorded frames (2.4 s of history)
+#define BLACKBOX_POST_FRAMES 10   // Frames kept after the trigger (0.5 s)
+
+// One recorded frame: readings reduced to 10 bits and packed like
+// RawCapture (right, left, middle at bits 0, 10, 20), state flags above
+struct BlackBoxFrame {
+    uint32_t packed;
+    int8_t angle;     // Estimated flame angle, degrees (0 without flame)
+    uint8_t servo;    // Servo position, degrees
+};
+
+#define BLACKBOX_FLAG_FLAME 0x40000000UL
+#define BLACKBOX_FLAG_PUMP  0x80000000UL
+
+// Records a frame every BLACKBOX_INTERVAL. EVENT_FLAME_START arms the
+// trigger; BLACKBOX_POST_FRAMES later the buffer freezes and keeps that
+// incident until rearm(). The dump goes through the logger a line at a
+// time whenever the UART buffer has room for a full line, so it never
+// stalls the loop and no line is dropped; recording pauses while a dump
+// is in progress.
+class BlackBox {
+public:
+    BlackBox();
+    void begin();
+    void record(FlameTriangulation& flameSensor, bool flameDetected, float angle,
+                int servoAngle, bool pumpActive);
+    bool isFrozen() const { return frozen; }
+    void rearm();
+    void startDump();
+    void serviceDump();   // Call every loop
+private:
+    BlackBoxFrame frames[BLACKBOX_FRAMES];
+    uint8_t head;           // Next slot to write
+    uint8_t count;
+    uint8_t postRemaining;
+    bool triggered;
+    bool frozen;
+    int8_t dumpLine;        // Next line to print, -1 when idle
+    unsigned long lastRecord;
+    const BlackBoxFrame& frameAt(uint8_t index) const;  // 0 = oldest
+    void printFrame(uint8_t index) const;
+    static void handleEvent(const Event& event, void* context);
+};
+
+#endif // BLACK_BOX_H
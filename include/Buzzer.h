@@ -13,9 +13,13 @@
 void initializeBuzzer();
 void updateBuzzer(bool flameDetected);
 void playTone(unsigned int frequency, unsigned long duration);
+// Tone sequences are non-blocking: updateBuzzer() plays them, and a new
+// one replaces the one playing
 void playStartupSequence();
+bool isBuzzerSequencePlaying();
 void playCalibrationTone();
 void playCalibrationFinishedTone();
 void playCalibrationWarningTone();
+void playSensorFaultTone();
 
 #endif // BUZZER_H 
\ No newline at end of file
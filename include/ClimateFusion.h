@@ -0,0 +1,52 @@
+#ifndef CLIMATE_FUSION_H
+#define CLIMATE_FUSION_H
+
+#include <Arduino.h>
+#include "FlameTriangulation.h"
+
+// Heat cues from the DHT sensor. A fire close to the unit warms and dries
+// the air within tens of seconds; heating, sun and weather take many
+// minutes. Temperature and humidity each feed a fast and a slow integer
+// EMA, like the ambient light tracking, and the gap between the two is
+// the recent rate of change:
+//   - rate of rise: the fast temperature EMA above the slow one by
+//     HEAT_RISE_LIMIT, about 2 C/min sustained or a 3 C step
+//   - humidity drop: the fast humidity EMA below the slow one by
+//     HUMIDITY_DROP_LIMIT
+// Each cue lowers FlameTriangulation's detection thresholds by a step
+// (HEAT_THRESHOLD_STEP). The cues never raise an alarm themselves: the
+// optical detector still decides, and a nuisance heat source only makes
+// it more sensitive while the air is changing.
+#define CLIMATE_FAST_SHIFT 2         // 2^2 readings, ~8 s at DHT_READ_INTERVAL
+#define CLIMATE_SLOW_SHIFT 5         // 2^5 readings, ~64 s
+#define HEAT_RISE_LIMIT 20           // Tenths of a degree C
+#define HUMIDITY_DROP_LIMIT 40       // Tenths of a percent RH
+
+// EMAs of one quantity in tenths, each kept as value << its shift; a
+// humidity of 100.0 % still fits an int at the slow shift
+struct ClimateTrack {
+    int fast;
+    int slow;
+};
+
+class ClimateFusion {
+public:
+    ClimateFusion();
+    // Every loop: takes a DHT reading when one is due and hands the cue
+    // count to the estimator. Skipped while a flame is detected, so the
+    // sensor's blocking read stays out of an incident as it always has.
+    void update(bool flameDetected, FlameTriangulation& flameSensor);
+    // One reading in degrees C and percent RH; returns the cue count
+    uint8_t observe(float temperature, float humidity);
+    uint8_t getHeatCues() const { return heatCues; }
+    int getRise() const;                 // Tenths of a degree C
+    int getHumidityDrop() const;         // Tenths of a percent RH
+    void printStatus();
+private:
+    ClimateTrack temperatureTrack;
+    ClimateTrack humidityTrack;
+    bool seeded;
+    uint8_t heatCues;
+};
+
+#endif // CLIMATE_FUSION_H
@@ -0,0 +1,41 @@
+#ifndef COMMAND_CHANNEL_H
+#define COMMAND_CHANNEL_H
+
+#include <Arduino.h>
+#include "SettingsRegistry.h"
+#include "BlackBox.h"
+#include "IncidentTimeline.h"
+
+#define COMMAND_BUFFER_SIZE 32  // Longest accepted command line, including terminator
+
+// Line-oriented serial commands for reading and tuning settings:
+//   get [name]         print one or all settings
+//   set <name> <value> change a setting (range checked)
+//   save / load        write to or read from EEPROM
+//   defaults           restore compiled-in defaults
+//   dump               print the black box recording
+//   rearm              release a frozen black box for the next incident
+//   kpi [clear]        print or reset the incident reaction-time statistics
+// poll() never blocks and never allocates: it drains whatever the serial
+// driver has buffered into a fixed line buffer and executes complete lines.
+// Replies go through the logger. A command is only taken while a full
+// reply line fits in the UART buffer, and the full settings listing goes
+// out a line at a time over later polls, so no reply is dropped.
+class CommandChannel {
+public:
+    CommandChannel(SettingsRegistry& registry, BlackBox& blackBox, IncidentTimeline& timeline);
+    bool poll();    // Returns true when settings changed
+private:
+    SettingsRegistry& registry;
+    BlackBox& blackBox;
+    IncidentTimeline& timeline;
+    char buffer[COMMAND_BUFFER_SIZE];
+    uint8_t length;
+    bool overflow;
+    int8_t listIndex;       // Next setting of a "get" listing, -1 when idle
+    bool execute(char* line);
+    void printSetting(uint8_t index);
+    static char* nextToken(char*& cursor);
+};
+
+#endif // COMMAND_CHANNEL_H
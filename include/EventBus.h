@@ -0,0 +1,49 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+
+// Maximum number of handlers that can be registered (statically allocated)
+#define EVENT_BUS_MAX_SUBSCRIBERS 8
+
+// Events published on state transitions between subsystems
+enum EventType : uint8_t {
+    EVENT_FLAME_START = 0,      // value: flame angle in degrees
+    EVENT_FLAME_END,            // value: unused
+    EVENT_ANGLE_CHANGED,        // value: new flame angle in degrees
+    EVENT_CALIBRATION_NEEDED,   // value: unused
+    EVENT_PUMP_STATE,           // value: 1 = relay closed, 0 = relay open
+    EVENT_SENSOR_FAULT,         // value: channel taken out of use
+    EVENT_SENSOR_RECOVERED,     // value: channel back in use
+    EVENT_TYPE_COUNT
+};
+
+#define EVENT_MASK(type) ((uint8_t)(1 << (type)))
+
+struct Event {
+    EventType type;
+    float value;
+};
+
+typedef void (*EventHandler)(const Event& event, void* context);
+
+class EventBus {
+public:
+    EventBus();
+    bool subscribe(uint8_t eventMask, EventHandler handler, void* context);
+    void publish(EventType type, float value = 0);
+    unsigned long getPublishCount() const;
+private:
+    struct Subscription {
+        uint8_t eventMask;
+        EventHandler handler;
+        void* context;
+    };
+    Subscription subscriptions[EVENT_BUS_MAX_SUBSCRIBERS];
+    uint8_t subscriberCount;
+    unsigned long publishCount;
+};
+
+extern EventBus eventBus;
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,42 @@
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+// Compile-time digital pin access for the ATmega328P (Uno/Nano pin numbering).
+// Port, bit mask and DDR are resolved by the compiler, so each call reduces
+// to a single sbi/cbi/sbic instruction instead of digitalWrite()'s table
+// lookups (roughly 2 cycles versus 50+). sbi/cbi are atomic, so no
+// interrupt masking is needed either.
+template <uint8_t PIN>
+class FastPin {
+    static_assert(PIN <= 19, "FastPin supports pins 0-19 (D0-D13, A0-A5)");
+    static const uint8_t bitIndex = PIN < 8 ? PIN : (PIN < 14 ? PIN - 8 : PIN - 14);
+public:
+    static const uint8_t mask = 1 << bitIndex;
+
+    static inline volatile uint8_t& port() __attribute__((always_inline)) {
+        return PIN < 8 ? PORTD : (PIN < 14 ? PORTB : PORTC);
+    }
+    static inline volatile uint8_t& ddr() __attribute__((always_inline)) {
+        return PIN < 8 ? DDRD : (PIN < 14 ? DDRB : DDRC);
+    }
+    static inline volatile uint8_t& pin() __attribute__((always_inline)) {
+        return PIN < 8 ? PIND : (PIN < 14 ? PINB : PINC);
+    }
+
+    static inline void output() __attribute__((always_inline)) { ddr() |= mask; }
+    static inline void input() __attribute__((always_inline)) { ddr() &= ~mask; port() &= ~mask; }
+    static inline void inputPullup() __attribute__((always_inline)) { ddr() &= ~mask; port() |= mask; }
+
+    static inline void high() __attribute__((always_inline)) { port() |= mask; }
+    static inline void low() __attribute__((always_inline)) { port() &= ~mask; }
+    static inline void write(bool value) __attribute__((always_inline)) {
+        if (value) high(); else low();
+    }
+    // Writing a one to PINx toggles the output latch
+    static inline void toggle() __attribute__((always_inline)) { pin() = mask; }
+    static inline bool read() __attribute__((always_inline)) { return pin() & mask; }
+};
+
+#endif // FAST_PIN_H
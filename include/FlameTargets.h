@@ -0,0 +1,36 @@
+#ifndef FLAME_TARGETS_H
+#define FLAME_TARGETS_H
+
+#include <Arduino.h>
+
+#define MAX_FLAME_TARGETS 4
+#define TARGET_MERGE_DEGREES 10   // Peaks closer than this are the same flame
+#define TARGET_TIMEOUT 20000      // Drop targets not seen for this long (ms)
+
+// A flame located by the scan, as a servo bearing in degrees
+struct FlameTarget {
+    int bearing;
+    float strength;           // Total relative intensity at the peak
+    unsigned long lastSeen;
+    bool serviced;            // Already had its dwell in the current round
+};
+
+class FlameTargetList {
+public:
+    FlameTargetList();
+    void observe(int bearing, float strength);
+    void touch(int bearing);
+    void expire(unsigned long timeout);
+    void remove(int index);
+    void clear();
+    int find(int bearing) const;
+    int highestPriority();
+    void markServiced(int index);
+    int count() const;
+    const FlameTarget& get(int index) const;
+private:
+    FlameTarget targets[MAX_FLAME_TARGETS];
+    int targetCount;
+};
+
+#endif // FLAME_TARGETS_H
@@ -2,18 +2,114 @@
 #define FLAME_TRIANGULATION_H
 
 #include <Arduino.h>
+#include "AdcSampler.h"
+#include "FlameTargets.h"
+#include "Settings.h"
+
+class IncidentTimeline;
+
+// Detection defaults (runtime-tunable via DetectionSettings)
+#define DEFAULT_NOISE_MULTIPLIER 6.0
+#define DEFAULT_FIXED_THRESHOLD (100 << ADC_OVERSAMPLE_BITS)
+
+constexpr DetectionSettings DEFAULT_DETECTION_SETTINGS = {
+    DEFAULT_NOISE_MULTIPLIER, DEFAULT_FIXED_THRESHOLD
+};
+
+// Compile-time detection constants; host tools build variants with -D to
+// compare them (tools/param_sweep)
+#ifndef SMOOTHING_WINDOW
+#define SMOOTHING_WINDOW 5          // Frames in the reading moving average
+#endif
+#ifndef DRIFT_MIN_SAMPLES
+#define DRIFT_MIN_SAMPLES 50        // Flame-free frames before drift is judged
+#endif
+#ifndef DRIFT_WARNING_COUNTS
+#define DRIFT_WARNING_COUNTS 75     // Drift that raises calibrationNeeded (10-bit counts)
+#endif
+#ifndef REBASELINE_STEP_COUNTS
+#define REBASELINE_STEP_COUNTS 4    // Largest automatic baseline move per check (10-bit counts)
+#endif
+#ifndef HEAT_THRESHOLD_STEP
+#define HEAT_THRESHOLD_STEP 1       // Sixteenths taken off the thresholds per heat cue (ClimateFusion)
+#endif
+
+// Sensor channels in firmware order: 0 = right, 1 = left, 2 = middle
+#define SENSOR_COUNT 3
+#define FLAME_DEBUG_LINES 15     // Lines in the printDebugLine report
+#define ALL_SENSORS_MASK 0x07
+
+// Running per-sensor noise statistics (integer Welford, count capped so
+// older samples are forgotten exponentially once the window is full)
+struct NoiseStats {
+    long mean;            // Q4 fixed point (counts * 16)
+    long variance;        // Q8 fixed point (counts^2 * 256)
+    unsigned int count;
+    uint8_t censored;     // Consecutive censored samples
+};
+
+// Ambient level of one sensor on flame-free frames: integer EMAs at two
+// time constants, each kept as value << its shift
+struct AmbientTrack {
+    long fast;
+    long slow;
+};
 
 class FlameTriangulation {
 private:
+    // Geometry and thresholds are compile-time constants: they cost no RAM
+    // per instance and fold into the code that uses them
+    
     // Sensor positions in cm (linear arrangement)
-    const float sensor1X = 5.0;  // Right sensor
-    const float sensor2X = -5.0; // Left sensor
-    const float sensor3X = 0.0;  // Middle sensor
-    const float sensorY = 0.0;   // All at same height
+    static constexpr float sensor1X = 5.0;  // Right sensor
+    static constexpr float sensor2X = -5.0; // Left sensor
+    static constexpr float sensor3X = 0.0;  // Middle sensor
+    static constexpr float sensorY = 0.0;   // All at same height
     
     // Sensor characteristics
-    const float sensorAngleLimit = 30.0; // Half of 60-degree detection angle
-    const int threshold = 100;            // Detection threshold (raw value difference)
+    static constexpr float sensorAngleLimit = 30.0; // Half of 60-degree detection angle
+    // Readings are ADC_SAMPLE_BITS wide; constants below are given in 10-bit
+    // counts and scaled by the oversampling gain
+    static constexpr int maxIntensityDiff = 500 << ADC_OVERSAMPLE_BITS; // Difference mapped to full intensity
+    
+    // CFAR detection: per-sensor threshold = config.noiseMultiplier * sigma,
+    // bounded so a silent sensor cannot trigger on quantization noise and a
+    // very noisy one still detects strong flames. config.fixedThreshold
+    // applies until the noise statistics settle.
+#ifdef FIXED_SETTINGS
+    static constexpr const DetectionSettings& config = DEFAULT_DETECTION_SETTINGS;
+#else
+    const DetectionSettings& config;
+#endif
+    static constexpr int minThreshold = 8 << ADC_OVERSAMPLE_BITS;
+    static constexpr int maxThreshold = 300 << ADC_OVERSAMPLE_BITS;
+    static const unsigned int NOISE_WINDOW = 256;      // Welford count cap
+    static const unsigned int NOISE_MIN_SAMPLES = 32;  // Samples before CFAR thresholds apply
+    static const int NOISE_DELTA_LIMIT = 2047;         // Q4 clamp on a single deviation
+    static const long NOISE_CENSOR_SIGMAS = 3;         // Deviations within this many sigma are never censored
+    static const uint8_t NOISE_RESEED_SAMPLES = 200;   // Censored in a row before the mean moves (~1 s)
+    // Channels used for detection and angle estimation (bit per channel);
+    // SensorHealth clears the bit of a faulty sensor
+    uint8_t channelMask;
+    NoiseStats noise1;
+    NoiseStats noise2;
+    NoiseStats noise3;
+    int detectThreshold1;
+    int detectThreshold2;
+    int detectThreshold3;
+    uint8_t heatCues;       // 0-2, from ClimateFusion
+    
+    // Scan peak extraction for multiple flames
+    static constexpr float PEAK_DIP_RATIO = 0.5; // A dip below this fraction of the peak starts a new lobe
+    FlameTargetList targets;
+    bool inPeak;
+    int peakHeading;
+    float peakIntensity;
+    
+    // Background at the current heading (BackgroundMap), removed from
+    // every reading before smoothing; raw readings keep it
+    int backgroundOffset[SENSOR_COUNT];
+    IncidentTimeline* timeline;
     
     // Raw and processed sensor readings
     int rawReading1;
@@ -24,30 +120,51 @@ private:
     int processedReading3;
     
     // Circular buffer for smoothing readings
-    static const int bufferSize = 5;
+    static const int bufferSize = SMOOTHING_WINDOW;
     int readingBuffer1[bufferSize];
     int readingBuffer2[bufferSize];
     int readingBuffer3[bufferSize];
     int bufferIndex;
     
-    // Ambient tracking variables
-    float avgAmbient1;
-    float avgAmbient2;
-    float avgAmbient3;
+    // Ambient tracking: the fast EMA follows 2^4 frames (~80 ms), the slow
+    // one 2^10 frames (~5 s)
+    AmbientTrack ambientTrack1;
+    AmbientTrack ambientTrack2;
+    AmbientTrack ambientTrack3;
     unsigned long lastAmbientUpdate;
     unsigned int validSampleCount;
     unsigned long cooldownEndTime;
-    static const int MIN_SAMPLES_FOR_DRIFT = 50;
-    static const int DRIFT_WARNING_THRESHOLD = 75;
+    static const uint8_t AMBIENT_FAST_SHIFT = 4;
+    static const uint8_t AMBIENT_SLOW_SHIFT = 10;
+    static const int MIN_SAMPLES_FOR_DRIFT = DRIFT_MIN_SAMPLES;
+    static const int DRIFT_WARNING_THRESHOLD = DRIFT_WARNING_COUNTS << ADC_OVERSAMPLE_BITS;
+    // Automatic re-baselining, applied per updateCalibrationMonitoring call
+    static const int REBASELINE_STEP = REBASELINE_STEP_COUNTS << ADC_OVERSAMPLE_BITS;
+    static const int AMBIENT_SETTLED_LIMIT = 8 << ADC_OVERSAMPLE_BITS; // Fast and slow EMAs this close = settled
+    static const int DRIFT_DEADBAND = 3 << ADC_OVERSAMPLE_BITS;        // Drift this small has no direction
+    // Total automatic move since the last calibration. Falling readings
+    // (more IR) are what a slowly growing flame looks like, so that way the
+    // baseline moves at half the step and half as far.
+    static const int FOLLOW_LIMIT = DRIFT_WARNING_THRESHOLD;
+    static const int FOLLOW_LIMIT_MORE_IR = DRIFT_WARNING_THRESHOLD / 2;
+    int calibratedLevel[SENSOR_COUNT];                                  // Baseline set by the last calibration
+    void resetAmbientTrack(AmbientTrack& track, int reading);
+    void updateAmbientTrack(AmbientTrack& track, int reading);
     
     // Methods
     void updateBuffers(int r1, int r2, int r3);
     int getSmoothedReading(int buffer[]);
     float angleFromIntensities(float intensity1, float intensity2, float intensity3);
-    float weightedAngularTriangulation();
-    float dualSensorEstimation();
     float getConfidenceMetric();
     void updateAmbientTracking(bool flameDetected);
+    void resetNoiseStats(NoiseStats& stats, int reading);
+    void updateNoiseStats(NoiseStats& stats, int reading, int threshold);
+    int noiseThreshold(const NoiseStats& stats);
+    void updateDetectionThresholds();
+    bool channelEnabled(uint8_t channel) const { return channelMask & (1 << channel); }
+    float leastSquaresBearing();
+    float bearingScore(uint8_t index, const int intensity[]);
+    void getChannelState(uint8_t channel, int& processed, int& ambient, int& threshold);
 
 public:
     // Calibration values (to be set during calibration)
@@ -60,29 +177,71 @@ public:
     bool calibrationNeeded;
     bool calibrationWarningTriggered;
     
-    FlameTriangulation();
+    FlameTriangulation(const DetectionSettings& config);
     
-    // Main interface methods
+    // Main interface methods. Calibration levels are given with the
+    // background already removed (reading - getBackground(channel)).
     void calibrate(int reading1, int reading2, int reading3);
     void updateReadings(int reading1, int reading2, int reading3);
     
     // Flame detection results
     bool isFlameDetected();
+    bool isRawSampleAboveThreshold();
     float getFlameAngle();
     float getConfidence();
+    float getTotalIntensity();
+    
+    // Former piecewise estimators, kept as baselines for the host and
+    // on-target benchmarks
+    float weightedAngularTriangulation();
+    float dualSensorEstimation();
+    
+    // Multiple flames: peaks of total intensity by servo heading
+    void observeHeading(int heading);
+    FlameTargetList& getTargets() { return targets; }
     
     // Made public for distance estimation
     float calculateRelativeIntensity(int reading, int ambient);
     
-    // Calibration monitoring
+    // Per-channel access for health monitoring, regardless of the mask
+    int getRawReading(uint8_t channel);
+    int getDetectionThreshold(uint8_t channel);
+    float getChannelIntensity(uint8_t channel);
+    bool isChannelDetecting(uint8_t channel);
+    int getCurrentAmbient(uint8_t channel);
+    
+    // Heading background, in sample counts (BackgroundMap)
+    void setBackground(uint8_t channel, int offset) { backgroundOffset[channel] = offset; }
+    int getBackground(uint8_t channel) const { return backgroundOffset[channel]; }
+    int getBackgroundResidual(uint8_t channel);  // Last raw reading less background and baseline
+    bool isQuiet();                              // No detection and past the post-flame cooldown
+    
+    // Stamp the first above-threshold sample and detection on each frame
+    // (nullptr detaches)
+    void attachTimeline(IncidentTimeline* timeline) { this->timeline = timeline; }
+    
+    // Degraded mode: detection and angle use only the channels in mask
+    void setChannelMask(uint8_t mask);
+    uint8_t getChannelMask() const { return channelMask; }
+    
+    // Recompute thresholds after DetectionSettings changed
+    void applySettings();
+    
+    // Heat cues (rate of rise, humidity drop) lower the thresholds, so a
+    // flame is confirmed sooner, and raise the confidence with them
+    void setHeatCues(uint8_t cues);
+    uint8_t getHeatCues() const { return heatCues; }
+    
+    // Calibration monitoring: follows slow ambient drift by moving the
+    // baseline, raises calibrationNeeded for drift it cannot follow
     void updateCalibrationMonitoring();
-    float getCurrentAmbient1() { return avgAmbient1; }
-    float getCurrentAmbient2() { return avgAmbient2; }
-    float getCurrentAmbient3() { return avgAmbient3; }
+    int getCurrentAmbient1() { return ambientTrack1.fast >> AMBIENT_FAST_SHIFT; }
+    int getCurrentAmbient2() { return ambientTrack2.fast >> AMBIENT_FAST_SHIFT; }
+    int getCurrentAmbient3() { return ambientTrack3.fast >> AMBIENT_FAST_SHIFT; }
     void resetCalibrationWarning();
     
-    // Debug info
-    void printDebugInfo();
+    // Debug report, one line per call (see FLAME_DEBUG_LINES)
+    void printDebugLine(uint8_t line);
 };
 
 #endif // FLAME_TRIANGULATION_H 
\ No newline at end of file
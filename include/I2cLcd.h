@@ -0,0 +1,40 @@
+#ifndef I2C_LCD_H
+#define I2C_LCD_H
+
+#include <Arduino.h>
+#include "TwiQueue.h"
+
+// PCF8574 backpack wiring (common modules): P0 = RS, P1 = RW, P2 = EN,
+// P3 = backlight, P4-P7 = D4-D7
+#define LCD_PIN_RS 0x01
+#define LCD_PIN_EN 0x04
+#define LCD_PIN_BACKLIGHT 0x08
+
+#define LCD_ROW_MAX 16  // Longest row writeRow() accepts
+
+// HD44780 in 4-bit mode behind a PCF8574 I2C expander, driven through
+// twiQueue. Every LCD byte becomes four expander writes (each nibble with
+// EN high, then low); one I2C byte takes about 90 us at 100 kHz, longer
+// than any data or cursor command needs, so frames carry no delays.
+// writeRow() queues a whole row as one frame and never blocks; the Print
+// interface (used by the examples) waits for queue space.
+class I2cLcd : public Print {
+public:
+    I2cLcd(uint8_t address);
+    void init();                 // Blocking power-on sequence
+    void backlight();
+    void noBacklight();
+    void setCursor(uint8_t col, uint8_t row);
+    bool writeRow(uint8_t row, const char* text, uint8_t length);  // false if the queue is full
+    size_t write(uint8_t value);
+    using Print::write;
+private:
+    uint8_t address;
+    uint8_t backlightBits;
+    uint8_t encode(uint8_t* out, uint8_t value, uint8_t mode) const;
+    void sendWaiting(const uint8_t* data, uint8_t length);
+    void command(uint8_t value);
+    void initNibble(uint8_t nibble);
+};
+
+#endif // I2C_LCD_H
@@ -0,0 +1,65 @@
+#ifndef INCIDENT_TIMELINE_H
+#define INCIDENT_TIMELINE_H
+
+#include <Arduino.h>
+
+// Reaction-time milestones of one incident, stamped with micros() by the
+// modules that reach them (attachTimeline() on each)
+enum Milestone : uint8_t {
+    MILESTONE_ABOVE_THRESHOLD = 0,  // First raw sample above threshold (FlameTriangulation)
+    MILESTONE_DETECTED,             // Smoothed detection confirmed (FlameTriangulation)
+    MILESTONE_TRACKING,             // Servo starts following the flame (ServoControl)
+    MILESTONE_ON_TARGET,            // Pump enabled: aimed at a live flame (PumpControl)
+    MILESTONE_RELAY,                // First relay closure (PumpControl)
+    MILESTONE_LAST_DETECTION,       // Last frame with detection (FlameTriangulation)
+    MILESTONE_COUNT
+};
+
+// KPIs: each milestone after the first, measured from it, plus the total
+// relay on-time
+#define INCIDENT_KPI_COUNT MILESTONE_COUNT
+
+// Running min/mean/max per KPI, kept in EEPROM behind the background map
+// so they add up across restarts; written once per incident. BackgroundMap
+// checks that the map ends before this (BACKGROUND_EEPROM_END).
+#define INCIDENT_EEPROM_ADDRESS 320
+#define INCIDENT_MAGIC 0x4B50
+
+// A raw sample above threshold that is not confirmed by a detection
+// within this long was noise and no longer starts the timeline
+#define TIMELINE_ARM_TIMEOUT 500000UL  // us
+
+// One incident's milestones. Opened by the first detection, closed by
+// PumpControl when the incident ends; the summary is then printed a line
+// at a time as the serial buffer has room:
+//
+//   Incident KPIs in us: last / min / mean / max (N)
+//   detect 61520 / 50040 / 88212 / 140336
+//   ...
+//
+// A milestone the incident never reached prints as "-".
+class IncidentTimeline {
+public:
+    IncidentTimeline();
+    void observeFrame(bool rawAboveThreshold, bool detected);  // Every sensor frame
+    void mark(Milestone milestone);      // First time per incident only
+    void relay(bool closed);
+    void close();
+    bool isOpen() const { return open; }
+    void startPrint();
+    void servicePrint();                 // Call every loop
+    void clearStats();
+private:
+    unsigned long stamps[MILESTONE_COUNT];
+    unsigned long lastRawAbove;
+    unsigned long relayClosedAt;
+    unsigned long relayMicros;
+    uint8_t marked;                      // Bit per milestone
+    bool open;
+    int8_t printLine;                    // Next summary line, -1 when idle
+    bool reached(Milestone milestone) const { return marked & (1 << milestone); }
+    bool kpi(uint8_t index, unsigned long& value) const;
+    void updateStats();
+};
+
+#endif // INCIDENT_TIMELINE_H
@@ -2,8 +2,7 @@
 #define LCD_H
 
 #include <Arduino.h>
-#include <Wire.h>
-#include <LiquidCrystal_I2C.h>
+#include "I2cLcd.h"
 #include <DHT.h>
 
 // LCD parameters
@@ -11,6 +10,7 @@
 #define LCD_COLS 16
 #define LCD_ROWS 2
 #define LCD_UPDATE_RATE 15 // LCD refresh rate in Hz (max 30Hz)
+#define LCD_I2C_FREQUENCY 100000 // PCF8574 maximum SCL clock
 
 // DHT Sensor parameters
 #define DHTPIN 3           // Digital pin connected to the DHT sensor
@@ -19,7 +19,7 @@
 #define DHT_DISPLAY_TOGGLE_INTERVAL 5000 // Time to alternate between temp and humidity display (5 seconds)
 
 // External LCD object declaration
-extern LiquidCrystal_I2C lcd;
+extern I2cLcd lcd;
 extern DHT dht;
 
 // External pump status variables
@@ -34,11 +34,12 @@ void updateLCD(bool flameDetected, float angle);
 void displayCalibrationMessage();
 void clearLCD();
 void showStartupMessage();
+void setLCDBacklight(bool on);
 void scrollLongText(const String& text, int row, int delay_ms);
 
 // DHT sensor functions
 void initializeDHT();
-void updateDHTReadings();
+bool updateDHTReadings();  // true when a new reading was taken
 float getTemperature();
 float getHumidity();
 void updateLCDWithTempHumidity(bool flameDetected, float angle);
@@ -51,4 +52,7 @@ void updateLCDWithCalibrationStatus(bool flameDetected, float angle, bool calibr
                                    int savedAmbient1, int savedAmbient2, int savedAmbient3,
                                    float currentAmbient1, float currentAmbient2, float currentAmbient3);
 
+// Sensor fault display (channelMask: sensors still in use)
+void displaySensorFault(uint8_t channelMask);
+
 #endif // LCD_H
\ No newline at end of file
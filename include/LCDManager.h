@@ -4,17 +4,33 @@
 #include <Arduino.h>
 #include "../include/LCD.h"
 #include "FlameTriangulation.h"
+#include "EventBus.h"
+#include "Settings.h"
+
+#define SENSOR_FAULT_DISPLAY_TIME 3000  // Sensor fault and idle screens alternate at this period (ms)
+#define STARTUP_SPLASH_TIME 2000        // Startup message stays up this long unless a flame is detected (ms)
+
+// DisplaySettings defaults
+#define DEFAULT_LCD_REFRESH_INTERVAL 500  // Minimum time between LCD updates (ms)
+
+constexpr DisplaySettings DEFAULT_DISPLAY_SETTINGS = { DEFAULT_LCD_REFRESH_INTERVAL };
 
 class LCDManager {
 public:
-    LCDManager(unsigned long refreshInterval);
+    LCDManager(const DisplaySettings& config);
+    void begin();
     void update(bool flameDetected, float angle, FlameTriangulation& flameSensor);
 private:
-    unsigned long refreshInterval;
+#ifdef FIXED_SETTINGS
+    static constexpr const DisplaySettings& config = DEFAULT_DISPLAY_SETTINGS;
+#else
+    const DisplaySettings& config;
+#endif
     unsigned long lastLCDUpdate;
-    bool lastFlameState;
-    float lastAngle;
+    bool contentChanged;
     bool dhtInitialized;
+    unsigned long splashEnd;
+    static void handleEvent(const Event& event, void* context);
 };
 
 #endif // LCD_MANAGER_H
@@ -0,0 +1,107 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Leveled serial logging. Each source file defines LOG_MODULE as its
+// module's level before using the macros; a message above that level
+// compiles to nothing, arguments included. A message is one line built
+// from F() strings and values:
+//
+//   LOG_INFO(F("Incident over: water "), water, F(" ms"));
+//
+// The line is formatted on the stack and handed to the UART only if its
+// transmit buffer has room for all of it. Otherwise it is dropped and
+// counted, so logging never waits for the serial port. Code that blocks
+// anyway (setup(), a button calibration) switches the logger to blocking
+// mode, where a line waits for room instead of being dropped.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Module levels; override with build flags, e.g. -DLOG_DETECTION=LOG_LEVEL_INFO
+#ifndef LOG_SYSTEM
+#define LOG_SYSTEM LOG_LEVEL_DEBUG     // main.cpp, BlackBox, CommandChannel: start-up, calibration, status report, replies
+#endif
+#ifndef LOG_DETECTION
+#define LOG_DETECTION LOG_LEVEL_DEBUG  // FlameTriangulation, AmbientMonitor
+#endif
+#ifndef LOG_HEALTH
+#define LOG_HEALTH LOG_LEVEL_DEBUG     // SensorHealth, StackProbe
+#endif
+#ifndef LOG_PUMP
+#define LOG_PUMP LOG_LEVEL_DEBUG       // PumpControl
+#endif
+#ifndef LOG_DISPLAY
+#define LOG_DISPLAY LOG_LEVEL_DEBUG    // LCD and DHT
+#endif
+#ifndef LOG_POWER
+#define LOG_POWER LOG_LEVEL_DEBUG      // PowerManager
+#endif
+#ifndef LOG_INCIDENT
+#define LOG_INCIDENT LOG_LEVEL_DEBUG   // IncidentTimeline summaries
+#endif
+
+// Longest line including "\r\n": what the AVR UART transmit buffer holds
+#define LOG_LINE_SIZE 63
+
+#define LOG_ENABLED(level) ((level) <= LOG_MODULE)
+#define LOG_AT(level, ...) do { if (LOG_ENABLED(level)) logger.line(__VA_ARGS__); } while (0)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+// A float printed with the given number of decimals
+struct LogFloat {
+    float value;
+    uint8_t digits;
+};
+inline LogFloat logFloat(float value, uint8_t digits) { return LogFloat{ value, digits }; }
+
+// One line being formatted; characters beyond LOG_LINE_SIZE - 2 are cut.
+// Lines assembled piece by piece (loops, helpers taking a Print&) are
+// built here directly and passed to Logger::commit, inside LOG_ENABLED().
+class LogLine : public Print {
+public:
+    LogLine() : length(0) {}
+    size_t write(uint8_t c);
+    using Print::write;
+private:
+    friend class Logger;
+    uint8_t length;
+    char text[LOG_LINE_SIZE];
+};
+
+class Logger {
+public:
+    Logger() : dropped(0), blocking(false) {}
+    template <typename... Args> void line(const Args&... args) {
+        LogLine out;
+        append(out, args...);
+        commit(out);
+    }
+    void commit(LogLine& out);
+    bool hasRoom() const;               // A full-length line would be sent now
+    uint16_t getDropped() const { return dropped; }
+    // Lines wait for room instead of being dropped; never from the loop
+    void setBlocking(bool wait) { blocking = wait; }
+private:
+    uint16_t dropped;
+    bool blocking;
+    static void append(LogLine&) {}
+    template <typename T, typename... Rest>
+    static void append(LogLine& out, const T& value, const Rest&... rest) {
+        put(out, value);
+        append(out, rest...);
+    }
+    template <typename T> static void put(LogLine& out, const T& value) { out.print(value); }
+    static void put(LogLine& out, const LogFloat& value) { out.print(value.value, value.digits); }
+};
+
+extern Logger logger;
+
+#endif // LOG_H
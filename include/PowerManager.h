@@ -0,0 +1,32 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// Idle sentinel timing
+#define SENTINEL_WDT_TIMEOUT WDTO_30MS   // Sample tick while asleep (keeps latency below the 50ms idle loop)
+#define SENTINEL_TICK_MS 30              // Nominal duration of SENTINEL_WDT_TIMEOUT
+#define SENTINEL_REPORT_INTERVAL 10000   // Duty cycle report period in milliseconds
+
+class PowerManager {
+public:
+    PowerManager(unsigned long idleEntryDelay);
+    void update(bool flameDetected);
+    bool isSentinelDue() const;
+    bool isSentinelActive() const;
+    void enterSentinel();
+    void exitSentinel();
+    void sleepUntilNextTick();
+    int sampleChannel(uint8_t pin);
+    void reportDutyCycle();
+private:
+    unsigned long idleEntryDelay;
+    unsigned long lastFlameTime;
+    bool sentinelActive;
+    unsigned long awakeStart;
+    unsigned long awakeMicros;
+    unsigned long sleptMicros;
+    unsigned long lastReportTime;
+};
+
+#endif // POWER_MANAGER_H
@@ -2,20 +2,98 @@
 #define PUMP_CONTROL_H
 
 #include <Arduino.h>
+#include "FastPin.h"
+#include "FlameTargets.h"
+#include "Settings.h"
+
+class IncidentTimeline;
+
+// Pump control relay (active low)
+#define PUMP_RELAY_PIN 6
+
+// PumpSettings defaults
+#define DEFAULT_PUMP_ANGLE_THRESHOLD 7.0  // Activate pump when within +/- degrees of target
+#define DEFAULT_PULSE_DURATION 1000       // Pulse length for a full-intensity, confident flame (ms)
+#define DEFAULT_PULSE_DELAY 1000          // Settle time between pulses (ms)
+#define DEFAULT_DWELL_LIMIT 8000          // Maximum time spent on one flame before servicing the next (ms)
+
+constexpr PumpSettings DEFAULT_PUMP_SETTINGS = {
+    DEFAULT_PUMP_ANGLE_THRESHOLD, DEFAULT_PULSE_DURATION, DEFAULT_PULSE_DELAY, DEFAULT_DWELL_LIMIT
+};
+
+// Target servicing
+#define EXTINGUISH_CONFIRM_TIME 1500  // No flame at the target bearing for this long = extinguished (ms)
+#define SURVEY_INTERVAL 15000         // Minimum time between surveys for further flames (ms)
+
+// Closed-loop pulsing
+#define PUMP_MIN_PULSE 200            // Shortest pulse worth firing (ms)
+#define PUMP_FULL_INTENSITY 1.5       // Total relative intensity that earns a full-length pulse
+#define PULSE_EFFECTIVE_RATIO 0.8     // A pulse is effective if it leaves less than this fraction of the intensity
+#define PULSE_OVERKILL_RATIO 0.4      // ...and more than needed if it leaves less than this
+#define EXTINGUISH_LOW_RATIO 0.05     // Intensity below this fraction of the target's peak...
+#define EXTINGUISH_HOLD_TIME 1000     // ...for this long declares the target out (ms)
+#define REIGNITE_RATIO 0.3            // Re-arm once intensity climbs back above this fraction of the peak
+#define EMBER_PULSE_COUNT 2           // Ineffective pulses below REIGNITE_RATIO of the peak that mean only embers are left
+
+// Water budget: the relay may be on for PUMP_DUTY_PERCENT of the time on
+// average, with bursts of up to PUMP_BURST_BUDGET ms
+#define PUMP_DUTY_PERCENT 50
+#define PUMP_BURST_BUDGET 8000
+#define INCIDENT_END_TIME 5000        // No live flame for this long closes the incident (ms)
 
 class PumpControl {
 public:
-    PumpControl(int relayPin, float angleThreshold, unsigned long pulseDuration, unsigned long pulseDelay);
+    PumpControl(const PumpSettings& config);
     void begin();
-    void update(bool flameDetected, int servoAngle, int targetServoAngle);
+    void update(bool flameDetected, int servoAngle, int targetServoAngle, float intensity, float confidence);
+    int selectTarget(FlameTargetList& targets, int servoAngle, bool flameDetected, bool surveying);
+    bool takeSurveyRequest();
     bool isPumpActive() const;
     bool isPumpEnabled() const;
+    bool isExtinguished() const;
+    unsigned long getIncidentWaterTime() const;
+    // Stamp aim, relay and incident end (nullptr detaches)
+    void attachTimeline(IncidentTimeline* timeline) { this->timeline = timeline; }
 private:
-    int relayPin;
-    float angleThreshold;
-    unsigned long pulseDuration, pulseDelay;
+    typedef FastPin<PUMP_RELAY_PIN> RelayPin;
+#ifdef FIXED_SETTINGS
+    static constexpr const PumpSettings& config = DEFAULT_PUMP_SETTINGS;
+#else
+    const PumpSettings& config;
+#endif
     bool pumpEnabled, pumpActive;
     unsigned long pumpStateChangeTime;
+    // Target scheduling
+    int serviceBearing;
+    unsigned long dwellStart;
+    unsigned long lastTargetFlameTime;
+    unsigned long lastSurveyTime;
+    bool surveyedThisIncident;
+    bool surveyRequested;
+    // Closed-loop pulsing
+    unsigned long currentPulse;
+    float pulseGain;
+    float prePulseIntensity;
+    float targetPeakIntensity;
+    unsigned long lowIntensitySince;
+    uint8_t ineffectivePulses;
+    bool extinguished;
+    int outBearing;
+    float outPeakIntensity;
+    // Water budget (ms x 100) and incident log
+    long budget;
+    unsigned long lastBudgetUpdate;
+    bool incidentActive;
+    unsigned long incidentStart, lastLiveFlameTime, incidentWater;
+    unsigned int incidentPulses;
+    IncidentTimeline* timeline;
+    void updateBudget(unsigned long now);
+    void trackExtinguish(bool flameDetected, bool aimed, float intensity, unsigned long now);
+    void updateIncident(bool liveFlame, unsigned long now);
+    void declareExtinguished(unsigned long now);
+    unsigned long pulseLength(float intensity, float confidence) const;
+    void setRelay(bool active, unsigned long now);
+    void resetTargetTracking();
 };
 
 #endif // PUMP_CONTROL_H
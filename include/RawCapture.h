@@ -0,0 +1,59 @@
+#ifndef RAW_CAPTURE_H
+#define RAW_CAPTURE_H
+
+#include <Arduino.h>
+
+// High-rate raw sample capture (RAW_CAPTURE in main.cpp).
+//
+// The ADC interrupt hands every CAPTURE_DECIMATION-th round-robin pass of
+// single 10-bit conversions to push(), which packs the triple into 30 bits
+// of a ring entry. flush() runs from the main loop and writes complete
+// frames to the serial port:
+//
+//   0xA5 0x5A  index (2, LE)  count  width  payload  crc8
+//
+// index is the sequence number of the first sample (wraps at 65536), so
+// the host sees both lost frames and samples dropped by a ring overrun.
+// The payload holds the first sample as 30 packed bits, then for each
+// further sample three width-bit two's complement deltas from the previous
+// one, LSB first and padded to a byte. crc8 (polynomial 0x07) covers
+// index through payload. The sync bytes never occur in ASCII, so text
+// printed by other modules can share the port and is skipped by the host.
+// tools/capture_decode turns the stream back into a trace file.
+
+#define CAPTURE_BAUD 500000        // Exact at 16 MHz, standard on Linux hosts
+// Raw passes per captured sample: 16 MHz / 128 / 13 / 3 channels ~ 3.2 kHz
+// passes, so 3 gives ~1.07 kHz triples
+#define CAPTURE_DECIMATION 3
+#define CAPTURE_FRAME_SAMPLES 16   // Samples per frame (fewer when a gap ends one)
+#define CAPTURE_BUFFER_SIZE 32     // Ring entries (power of two), ~30 ms at 1 kHz
+#define CAPTURE_SYNC1 0xA5
+#define CAPTURE_SYNC2 0x5A
+
+class RawCapture {
+public:
+    RawCapture();
+    void start();
+    void stop();
+    bool isActive() const;
+    // Called from the ADC conversion complete interrupt
+    void push(uint16_t reading1, uint16_t reading2, uint16_t reading3);
+    // Writes every complete frame waiting in the ring; returns frames written
+    uint8_t flush(Print& out);
+    uint16_t getLostCount() const;
+private:
+    // Bit 31 clear: sample, channels at bits 0, 10 and 20.
+    // Bit 31 set: gap marker, low 16 bits count the samples dropped there.
+    volatile uint32_t ring[CAPTURE_BUFFER_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint16_t pendingLost;  // Dropped since the last stored marker
+    volatile uint16_t lostCount;
+    volatile bool active;
+    uint16_t nextIndex;             // Sequence number of the sample at tail
+    void writeFrame(Print& out, uint8_t count);
+};
+
+extern RawCapture rawCapture;
+
+#endif // RAW_CAPTURE_H
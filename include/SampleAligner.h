@@ -0,0 +1,23 @@
+#ifndef SAMPLE_ALIGNER_H
+#define SAMPLE_ALIGNER_H
+
+#include <Arduino.h>
+#include "AdcSampler.h"
+
+// Skew correction for the round-robin sampler. The channels of a triple
+// are captured one conversion apart (104 us at /128, plus interrupt
+// latency), so a flickering flame changes between them and the
+// intensity ratios the angle is estimated from pick that up as jitter.
+// Each channel is interpolated back to the capture time of the earliest
+// one along the line to its previous frame:
+//   x(T) = x(n) - (x(n) - x(n-1)) * (t(n) - T) / (t(n) - t(n-1))
+// The previous frame is the one the sampler kept with the triple, so the
+// loop reading only one frame in several does not matter. The first frame
+// after begin() has none and is passed through.
+
+class SampleAligner {
+public:
+    void align(const SampleTriple& triple, int& reading1, int& reading2, int& reading3);
+};
+
+#endif // SAMPLE_ALIGNER_H
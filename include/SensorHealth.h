@@ -0,0 +1,57 @@
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+#include <Arduino.h>
+#include "FlameTriangulation.h"
+
+// Symptoms checked on every sensor frame
+#define HEALTH_RAIL_MARGIN (2 << ADC_OVERSAMPLE_BITS)     // Within this of 0 = saturated or shorted
+#define HEALTH_FLAT_FRAMES 1000                           // Identical consecutive readings of a dead channel (~5 s)
+#define HEALTH_FAMILY_LIMIT (200 << ADC_OVERSAMPLE_BITS)  // Ambient this far from the median of all three = out of family
+#define HEALTH_CENTRE_ANGLE 10.0   // Response is compared on flames within this angle of the axis...
+#define HEALTH_RESPONSE_MIN 0.1    // ...seen by the neighbours with at least this intensity
+#define HEALTH_RESPONSE_RATIO 0.35 // Less than this fraction of the neighbours' intensity = weak
+
+// A symptom must persist for the confirm time to take a channel out of use,
+// and be absent for the recovery time to bring it back
+#define HEALTH_CONFIRM_TIME 1000
+#define HEALTH_RECOVERY_TIME 10000
+
+enum SensorFault : uint8_t {
+    SENSOR_FAULT_RAIL = 1,    // Pinned at 0 while the others see nothing
+    SENSOR_FAULT_FLAT = 2,    // No noise at all while seeing nothing: stuck or disconnected
+    SENSOR_FAULT_FAMILY = 4,  // Baseline far from the other sensors (dirty or misaligned)
+    SENSOR_FAULT_WEAK = 8     // Answers a centred flame much more weakly than its neighbours
+};
+
+// Per-channel health checks. Faulty channels are removed from the
+// estimator's channel mask so detection and angle estimation continue on
+// the remaining sensors; every change is announced on the event bus. If
+// every channel is faulty, all three stay in use.
+class SensorHealth {
+public:
+    SensorHealth();
+    void reset();
+    void update(FlameTriangulation& flameSensor);  // Once per sensor frame
+    uint8_t getFaults(uint8_t channel) const;
+    bool isDegraded() const;
+    void printStatus() const;
+private:
+    struct ChannelHealth {
+        int lastReading;
+        unsigned int flatFrames;
+        int responseRatio;            // Q8 running ratio to the neighbours' intensity
+        uint8_t faults;               // SensorFault bits
+        bool symptomatic;
+        unsigned long since;          // Time symptomatic last changed
+    };
+    ChannelHealth channels[SENSOR_COUNT];
+    bool allFaulty;                   // Every channel faulty, all kept in use
+    uint8_t checkSymptoms(FlameTriangulation& flameSensor, uint8_t channel, int median);
+    void updateResponse(FlameTriangulation& flameSensor);
+    void updateFaults(uint8_t channel, uint8_t symptoms, unsigned long now);
+    static void printChannel(Print& out, uint8_t channel);
+    static void printFaults(Print& out, uint8_t faults);
+};
+
+#endif // SENSOR_HEALTH_H
@@ -3,22 +3,66 @@
 
 #include <Arduino.h>
 #include <Servo.h>
+#include "Settings.h"
 
+class IncidentTimeline;
+
+// Scan limits (servo degrees)
+#define SCAN_MIN_ANGLE 30
+#define SCAN_MAX_ANGLE 150
+
+// ServoSettings defaults
+#define DEFAULT_SCAN_STEP 1         // Degrees per step
+#define DEFAULT_SCAN_DELAY 30       // Milliseconds between steps
+#define DEFAULT_TRACKING_SPEED 0.1  // Lerp factor (0.0-1.0) - higher values = faster tracking
+
+constexpr ServoSettings DEFAULT_SERVO_SETTINGS = {
+    DEFAULT_SCAN_STEP, DEFAULT_SCAN_DELAY, DEFAULT_TRACKING_SPEED
+};
+
+#define SURVEY_STEP 2   // Degrees per step while surveying for further flames
+#define SLEW_STEP 3     // Degrees per step when moving to a known target
+#define SERVICE_TRACK_WINDOW 5  // Tracking stays this close to a serviced target's bearing
+
+// With FIXED_SETTINGS the scan limits and settings are compile-time
+// constants (SCAN_MIN_ANGLE, SCAN_MAX_ANGLE, DEFAULT_SERVO_SETTINGS) and
+// the matching constructor arguments are ignored.
 class ServoControl {
 public:
-    ServoControl(int pin, int minAngle, int maxAngle, int scanStep, int scanDelay, float trackingSpeed);
+    ServoControl(int pin, int minAngle, int maxAngle, const ServoSettings& config);
     void begin(int initialAngle);
-    void update(bool flameDetected, float flameAngle);
+    void update(bool flameDetected, float flameAngle, int serviceBearing = -1);
+    void startSurvey();
+    bool isSurveying() const;
+    // Search within window degrees of bearing for legs sweeps before the
+    // full scan resumes
+    void reacquire(int bearing, int window, int legs);
+    void moveTo(int angle);     // Immediately, for the calibration survey
+    // Stamp when the head starts following a flame (nullptr detaches)
+    void attachTimeline(IncidentTimeline* timeline) { this->timeline = timeline; }
+    void suspend();
+    void resume();
     int getCurrentAngle() const;
     int getTargetAngle() const;
 private:
     Servo servo;
     int servoPin;
-    int minAngle, maxAngle, scanStep, currentAngle, targetAngle;
-    float trackingSpeed;
+#ifdef FIXED_SETTINGS
+    static constexpr int minAngle = SCAN_MIN_ANGLE;
+    static constexpr int maxAngle = SCAN_MAX_ANGLE;
+    static constexpr const ServoSettings& config = DEFAULT_SERVO_SETTINGS;
+#else
+    int minAngle, maxAngle;
+    const ServoSettings& config;
+#endif
+    int currentAngle, targetAngle;
     bool scanDirection;
     unsigned long lastServoUpdate;
-    int scanDelay;
+    int surveyLegs;
+    int reacquireBearing;
+    uint8_t reacquireWindow, reacquireLegs;
+    IncidentTimeline* timeline;
+    bool scanStepOnce(int step, int low, int high);
     int mapFlameAngleToServo(float flameAngle);
     int lerpAngle(int current, int target, float factor);
 };
@@ -0,0 +1,45 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <Arduino.h>
+
+// Runtime-tunable parameters, grouped by the module that uses them. Each
+// module keeps a reference to its group and reads it on every update, so
+// a value changed over the serial command channel takes effect at once.
+// Defaults are the DEFAULT_*_SETTINGS constants in the module headers.
+//
+// Building with FIXED_SETTINGS defined (env:uno_fixed in platformio.ini)
+// replaces each module's reference with its DEFAULT_*_SETTINGS constant,
+// so the compiler folds the values into the control paths. The command
+// channel can still read the settings but refuses to change them.
+
+struct ServoSettings {
+    int scanStep;            // Degrees per scan step
+    int scanDelay;           // Milliseconds between steps
+    float trackingSpeed;     // Lerp factor (0.0-1.0)
+};
+
+struct PumpSettings {
+    float angleThreshold;        // Aim tolerance in degrees
+    unsigned long pulseDuration; // Full-intensity pulse length (ms)
+    unsigned long pulseDelay;    // Settle time between pulses (ms)
+    unsigned long dwellLimit;    // Maximum time on one flame (ms)
+};
+
+struct DetectionSettings {
+    float noiseMultiplier;   // CFAR threshold in standard deviations (0 = fixed only)
+    int fixedThreshold;      // Threshold until noise statistics settle (oversampled counts)
+};
+
+struct DisplaySettings {
+    unsigned long refreshInterval; // Minimum time between LCD updates (ms)
+};
+
+struct Settings {
+    ServoSettings servo;
+    PumpSettings pump;
+    DetectionSettings detection;
+    DisplaySettings display;
+};
+
+#endif // SETTINGS_H
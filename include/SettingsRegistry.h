@@ -0,0 +1,47 @@
+#ifndef SETTINGS_REGISTRY_H
+#define SETTINGS_REGISTRY_H
+
+#include <Arduino.h>
+#include "Settings.h"
+
+// EEPROM layout: a small header followed by the Settings struct. A size
+// or checksum mismatch (new firmware, blank EEPROM) falls back to defaults.
+#define SETTINGS_EEPROM_ADDRESS 0
+#define SETTINGS_MAGIC 0x4654
+
+enum SettingType : uint8_t {
+    SETTING_INT,
+    SETTING_ULONG,
+    SETTING_FLOAT
+};
+
+// One named parameter: where it lives inside Settings and its legal range.
+// Entries are stored in flash.
+struct SettingInfo {
+    const char* name;   // PROGMEM string
+    SettingType type;
+    uint8_t offset;     // Byte offset into Settings
+    float minValue;
+    float maxValue;
+};
+
+class SettingsRegistry {
+public:
+    // defaults must point to a Settings instance stored in PROGMEM
+    SettingsRegistry(Settings& settings, const Settings* defaults);
+    bool load();                // Returns false and applies defaults if EEPROM is invalid
+    void save();
+    void restoreDefaults();
+    uint8_t count() const;
+    int find(const char* name) const;            // Index, or -1 if unknown
+    bool set(uint8_t index, float value);        // false if out of range
+    float get(uint8_t index) const;
+    void print(uint8_t index, Print& out) const; // "name = value", no line end
+private:
+    Settings& settings;
+    const Settings* defaults;
+    static uint8_t checksum(const Settings& values);
+    void readInfo(uint8_t index, SettingInfo& info) const;
+};
+
+#endif // SETTINGS_REGISTRY_H
@@ -1,14 +1,23 @@
 #ifndef SIREN_LED_CONTROLLER_H
 #define SIREN_LED_CONTROLLER_H
 #include <Arduino.h>
+#include "EventBus.h"
+#include "FastPin.h"
+
+// Siren LED pins
+#define SIREN_LED1_PIN 4
+#define SIREN_LED2_PIN 5
+#define SIREN_INTERVAL 300 // ms between siren LED toggles
 
 class SirenLEDController {
-    int pin1, pin2;
-    bool state = false;
+    typedef FastPin<SIREN_LED1_PIN> Led1;
+    typedef FastPin<SIREN_LED2_PIN> Led2;
+    bool active = false;
     unsigned long lastToggle = 0;
+    static void handleEvent(const Event& event, void* context);
 public:
-    void setup(int led1, int led2);
-    void update(bool fireDetected);
+    void setup();
+    void update();
 };
 
 #endif // SIREN_LED_CONTROLLER_H
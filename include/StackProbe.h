@@ -0,0 +1,15 @@
+#ifndef STACK_PROBE_H
+#define STACK_PROBE_H
+
+#include <Arduino.h>
+
+// Byte pattern written over free SRAM before main() runs
+#define STACK_PAINT_PATTERN 0xC5
+
+// Bytes between the heap top and the deepest stack use seen so far
+uint16_t getStackHeadroom();
+// Bytes currently free between the heap top and the stack pointer
+uint16_t getFreeMemory();
+void printMemoryReport();
+
+#endif // STACK_PROBE_H
@@ -0,0 +1,38 @@
+#ifndef TWI_QUEUE_H
+#define TWI_QUEUE_H
+
+#include <Arduino.h>
+
+// Queue capacity in bytes. Each frame takes its length plus two header
+// bytes (address, length); one LCD row is a 70-byte frame.
+#define TWI_QUEUE_SIZE 160
+
+// Interrupt-driven I2C master transmitter. send() copies a frame into a
+// static ring buffer and returns at once; the TWI interrupt clocks the
+// frames out in the background. A full queue is reported to the caller
+// (back-pressure) instead of blocking. Replaces the Wire library, whose
+// endTransmission() busy-waits for every transfer, and owns TWI_vect.
+class TwiQueue {
+public:
+    TwiQueue();
+    void begin(unsigned long frequency);
+    bool send(uint8_t address, const uint8_t* data, uint8_t length);  // false if there is no room
+    void flush();                        // Wait until every queued frame is on the bus
+    bool isIdle() const { return !busy; }
+    unsigned int getNackCount() const { return nackCount; }
+    void handleInterrupt();
+private:
+    uint8_t buffer[TWI_QUEUE_SIZE];
+    volatile uint8_t head;               // Written by send()
+    volatile uint8_t tail;               // Advanced by the interrupt
+    volatile bool busy;
+    volatile unsigned int nackCount;
+    uint8_t frameRemaining;              // Data bytes left in the frame on the bus
+    uint8_t used() const;
+    uint8_t next(uint8_t index) const { return index + 1 < TWI_QUEUE_SIZE ? index + 1 : 0; }
+    void startFrame();
+};
+
+extern TwiQueue twiQueue;
+
+#endif // TWI_QUEUE_H
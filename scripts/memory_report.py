@@ -0,0 +1,163 @@
+"""Per-module RAM/flash footprint report built from the linker map file.
+
+Used as a PlatformIO extra script, it adds the linker flag that writes
+the map file and registers a `memreport` target:
+
+    pio run -e uno -t memreport
+
+It can also be run on an existing map file:
+
+    python scripts/memory_report.py .pio/build/uno/firmware.map --ram-budget 1600
+
+The target fails when the static RAM (.data + .bss) or flash
+(.text + .data initialisers) total exceeds its budget. Budgets are read
+from `custom_ram_budget` / `custom_flash_budget` in platformio.ini.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+MAP_NAME = "firmware.map"
+
+# " .text.setup   0x0000012c   0x2a /path/to/main.cpp.o"
+INPUT_SECTION = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+# Long section names are printed alone with the address/size on the next line
+SECTION_ONLY = re.compile(r"^ (\.\S+|COMMON)$")
+CONTINUATION = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(\s|$)")
+
+
+def module_name(path):
+    """Map an object path to a short module name."""
+    path = path.replace("\\", "/")
+    archive = re.match(r"(.*)\((.*)\)$", path)
+    if archive:
+        lib = os.path.basename(archive.group(1))
+        if "FrameworkArduino" in lib:
+            return "arduino-core"
+        if lib.startswith("libc") or lib.startswith("libm") or lib.startswith("libgcc"):
+            return "avr-libc"
+        return lib[3:-2] if lib.startswith("lib") and lib.endswith(".a") else lib
+    if "/src/" in path:
+        return os.path.basename(path).split(".")[0]
+    if "/lib" in path:
+        parts = path.split("/")
+        for i, part in enumerate(parts):
+            if part.startswith("lib") and i + 1 < len(parts):
+                return parts[i + 1]
+    return os.path.basename(path).split(".")[0]
+
+
+def classify(output_section):
+    if output_section == ".text":
+        return "text"
+    if output_section == ".data":
+        return "data"
+    if output_section in (".bss", ".noinit"):
+        return "bss"
+    return None
+
+
+def parse_map(map_path):
+    """Return {module: {"text": n, "data": n, "bss": n}} for linked sections."""
+    modules = {}
+    current = None
+    pending = None
+    in_memory_map = False
+    with open(map_path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Linker script and memory map"):
+                in_memory_map = True
+                continue
+            if not in_memory_map:
+                continue  # Skips "Discarded input sections"
+            out = OUTPUT_SECTION.match(line)
+            if out:
+                current = classify(out.group(1))
+                pending = None
+                continue
+            if current is None:
+                continue
+            match = INPUT_SECTION.match(line)
+            if match:
+                size, obj = int(match.group(3), 16), match.group(4)
+            elif pending and CONTINUATION.match(line):
+                cont = CONTINUATION.match(line)
+                size, obj = int(cont.group(2), 16), cont.group(3)
+            else:
+                pending = SECTION_ONLY.match(line)
+                continue
+            pending = None
+            if size == 0:
+                continue
+            entry = modules.setdefault(module_name(obj), {"text": 0, "data": 0, "bss": 0})
+            entry[current] += size
+    return modules
+
+
+def report(modules, ram_budget, flash_budget):
+    """Print the table; return False when a budget is exceeded."""
+    rows = sorted(modules.items(), key=lambda kv: -(kv[1]["data"] + kv[1]["bss"]))
+    print("%-24s %8s %8s %8s %8s" % ("Module", "Flash", "RAM", ".data", ".bss"))
+    total_flash = total_ram = 0
+    for name, s in rows:
+        flash = s["text"] + s["data"]
+        ram = s["data"] + s["bss"]
+        total_flash += flash
+        total_ram += ram
+        print("%-24s %8d %8d %8d %8d" % (name, flash, ram, s["data"], s["bss"]))
+    print("%-24s %8d %8d" % ("TOTAL", total_flash, total_ram))
+
+    ok = True
+    if ram_budget and total_ram > ram_budget:
+        print("RAM budget exceeded: %d > %d bytes" % (total_ram, ram_budget))
+        ok = False
+    if flash_budget and total_flash > flash_budget:
+        print("Flash budget exceeded: %d > %d bytes" % (total_flash, flash_budget))
+        ok = False
+    if ok:
+        print("Within budget (RAM %d/%s, flash %d/%s)" % (
+            total_ram, ram_budget or "-", total_flash, flash_budget or "-"))
+    if ram_budget:
+        # What a static buffer such as the black box ring may still take
+        print("RAM headroom under budget: %d bytes" % (ram_budget - total_ram))
+    return ok
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map_file")
+    parser.add_argument("--ram-budget", type=int, default=0)
+    parser.add_argument("--flash-budget", type=int, default=0)
+    args = parser.parse_args(argv)
+    ok = report(parse_map(args.map_file), args.ram_budget, args.flash_budget)
+    return 0 if ok else 1
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+except NameError:
+    env = None
+
+if env is not None:
+    map_path = os.path.join(env.subst("$BUILD_DIR"), MAP_NAME)
+    env.Append(LINKFLAGS=["-Wl,-Map," + map_path])
+
+    def memreport_action(target, source, env):
+        ram_budget = int(env.GetProjectOption("custom_ram_budget", "0"))
+        flash_budget = int(env.GetProjectOption("custom_flash_budget", "0"))
+        if not report(parse_map(map_path), ram_budget, flash_budget):
+            env.Exit(1)
+
+    env.AddCustomTarget(
+        name="memreport",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=memreport_action,
+        title="Memory Report",
+        description="Per-module RAM/flash usage with budget check",
+    )
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
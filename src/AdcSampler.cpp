@@ -0,0 +1,126 @@
+#include "../include/AdcSampler.h"
+#include <avr/interrupt.h>
+
+AdcSampler adcSampler;
+
+ISR(ADC_vect) {
+    // Also used as a bare wake-up source by PowerManager::sampleChannel()
+    if (adcSampler.isRunning()) adcSampler.handleConversion(ADC);
+}
+
+AdcSampler::AdcSampler()
+    : hasFrame(false), hasPrevious(false), currentChannel(0), sampleCount(0), frameReady(false), running(false),
+      capture(nullptr), captureDivider(0) {
+    for (uint8_t i = 0; i < ADC_SAMPLER_CHANNELS; i++) {
+        channels[i] = 0;
+        sums[i] = 0;
+        frame[i] = 0;
+        frameStamps[i] = 0;
+        previousFrame[i] = 0;
+        previousStamps[i] = 0;
+        stamps[i] = 0;
+        raw[i] = 0;
+    }
+}
+
+void AdcSampler::begin(uint8_t pin1, uint8_t pin2, uint8_t pin3) {
+    stop();
+    channels[0] = (pin1 - A0) & 0x07;
+    channels[1] = (pin2 - A0) & 0x07;
+    channels[2] = (pin3 - A0) & 0x07;
+    for (uint8_t i = 0; i < ADC_SAMPLER_CHANNELS; i++) sums[i] = 0;
+    currentChannel = 0;
+    sampleCount = 0;
+    frameReady = false;
+    // The first frame after a restart does not follow the last one before
+    hasFrame = false;
+    hasPrevious = false;
+    running = true;
+    ADCSRA = (1 << ADEN) | (1 << ADIE) | ADC_PRESCALER_BITS;
+    startConversion();
+}
+
+void AdcSampler::stop() {
+    ADCSRA &= ~(1 << ADIE);
+    running = false;
+    // Let a conversion in flight finish so analogRead() starts clean
+    while (ADCSRA & (1 << ADSC)) {}
+}
+
+bool AdcSampler::isRunning() const { return running; }
+
+bool AdcSampler::available() const { return frameReady; }
+
+void AdcSampler::read(int& reading1, int& reading2, int& reading3) {
+    uint8_t oldSREG = SREG;
+    cli();
+    reading1 = frame[0];
+    reading2 = frame[1];
+    reading3 = frame[2];
+    frameReady = false;
+    SREG = oldSREG;
+}
+
+void AdcSampler::read(SampleTriple& triple) {
+    uint8_t oldSREG = SREG;
+    cli();
+    for (uint8_t i = 0; i < ADC_SAMPLER_CHANNELS; i++) {
+        triple.reading[i] = frame[i];
+        triple.stamp[i] = frameStamps[i];
+        triple.previous[i] = previousFrame[i];
+        triple.previousStamp[i] = previousStamps[i];
+    }
+    triple.hasPrevious = hasPrevious;
+    frameReady = false;
+    SREG = oldSREG;
+}
+
+void AdcSampler::waitForFrame(int& reading1, int& reading2, int& reading3) {
+    while (!frameReady) {}
+    read(reading1, reading2, reading3);
+}
+
+void AdcSampler::attachCapture(RawCapture* capture) {
+    this->capture = capture;
+}
+
+void AdcSampler::startConversion() {
+    // Single conversions: the multiplexer is switched before each start,
+    // so every result belongs to the channel that was selected
+    ADMUX = (1 << REFS0) | channels[currentChannel];
+    ADCSRA |= (1 << ADSC);
+    // Conversions of a channel are evenly spaced, so the middle of the
+    // first and last start is the centre of the frame's average
+    uint16_t now = micros();
+    if (sampleCount == 0) stamps[currentChannel] = now;
+    if (sampleCount == ADC_OVERSAMPLE_COUNT - 1) {
+        stamps[currentChannel] += (uint16_t)(now - stamps[currentChannel]) / 2;
+    }
+}
+
+void AdcSampler::handleConversion(uint16_t value) {
+    sums[currentChannel] += value;
+    if (capture) raw[currentChannel] = value;
+    if (++currentChannel == ADC_SAMPLER_CHANNELS) {
+        currentChannel = 0;
+        if (capture && ++captureDivider == CAPTURE_DECIMATION) {
+            captureDivider = 0;
+            capture->push(raw[0], raw[1], raw[2]);
+        }
+        if (++sampleCount == ADC_OVERSAMPLE_COUNT) {
+            // Decimate: 4^n summed samples >> n gives n extra bits
+            for (uint8_t i = 0; i < ADC_SAMPLER_CHANNELS; i++) {
+                previousFrame[i] = frame[i];
+                previousStamps[i] = frameStamps[i];
+                frame[i] = sums[i] >> ADC_OVERSAMPLE_BITS;
+                frameStamps[i] = stamps[i];
+                sums[i] = 0;
+            }
+            hasPrevious = hasFrame;
+            hasFrame = true;
+            sampleCount = 0;
+            frameReady = true;
+        }
+    }
+    startConversion();
+}
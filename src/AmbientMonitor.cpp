@@ -1,5 +1,8 @@
 #include "../include/AmbientMonitor.h"
-#include "../include/Buzzer.h"
+#include "../include/EventBus.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_DETECTION
 
 AmbientMonitor::AmbientMonitor(unsigned long interval)
     : checkInterval(interval), lastAmbientCheck(0) {}
@@ -11,8 +14,8 @@ void AmbientMonitor::update(FlameTriangulation& flameSensor) {
         flameSensor.updateCalibrationMonitoring();
         if (flameSensor.calibrationNeeded && !flameSensor.calibrationWarningTriggered) {
             flameSensor.calibrationWarningTriggered = true;
-            playCalibrationWarningTone();
-            Serial.println(F("CALIBRATION WARNING: Ambient drift detected!"));
+            eventBus.publish(EVENT_CALIBRATION_NEEDED);
+            LOG_WARN(F("CALIBRATION WARNING: Ambient drift detected!"));
         }
     }
 }
@@ -0,0 +1,155 @@
+#include "../include/BackgroundMap.h"
+#include "../include/IncidentTimeline.h"
+#include <EEPROM.h>
+
+// Stored in front of the bins; a magic or bin count mismatch (blank EEPROM,
+// new scan range) starts an empty map
+struct BackgroundHeader {
+    uint16_t magic;
+    uint8_t bins;
+    uint8_t fireBearing;
+    int16_t baseline[SENSOR_COUNT];
+};
+
+#define BACKGROUND_FIRE_ADDRESS (BACKGROUND_EEPROM_ADDRESS + offsetof(BackgroundHeader, fireBearing))
+#define BACKGROUND_BASELINE_ADDRESS (BACKGROUND_EEPROM_ADDRESS + offsetof(BackgroundHeader, baseline))
+#define BACKGROUND_LEARN_MAX_FRAMES 8    // Keeps a pass's sums within an int
+
+static_assert(sizeof(Settings) + 8 <= BACKGROUND_EEPROM_ADDRESS, "Settings block overlaps the background map");
+static_assert(sizeof(BackgroundHeader) == BACKGROUND_HEADER_SIZE, "BACKGROUND_HEADER_SIZE is out of date");
+static_assert(BACKGROUND_EEPROM_END <= INCIDENT_EEPROM_ADDRESS, "Background map overlaps the incident statistics");
+
+BackgroundMap::BackgroundMap()
+    : appliedBin(0xFF), learnBin(0xFF), learnFrames(0), fireBearing(NO_FIRE_BEARING), firePending(false) {}
+
+bool BackgroundMap::load() {
+    BackgroundHeader header;
+    EEPROM.get(BACKGROUND_EEPROM_ADDRESS, header);
+    appliedBin = 0xFF;
+    if (header.magic != BACKGROUND_MAGIC || header.bins != BACKGROUND_BINS) {
+        clear();
+        return false;
+    }
+    fireBearing = header.fireBearing;
+    return true;
+}
+
+void BackgroundMap::clear() {
+    BackgroundHeader header = { BACKGROUND_MAGIC, BACKGROUND_BINS, NO_FIRE_BEARING,
+                                { NO_BASELINE, NO_BASELINE, NO_BASELINE } };
+    // put() and update() only rewrite bytes that changed
+    EEPROM.put(BACKGROUND_EEPROM_ADDRESS, header);
+    for (uint8_t bin = 0; bin < BACKGROUND_BINS; bin++) {
+        for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) EEPROM.update(address(bin, ch), 0);
+    }
+    fireBearing = NO_FIRE_BEARING;
+    firePending = false;
+    appliedBin = 0xFF;
+}
+
+uint8_t BackgroundMap::binOf(int heading) {
+    int bin = (heading - SCAN_MIN_ANGLE + BACKGROUND_BIN_DEGREES / 2) / BACKGROUND_BIN_DEGREES;
+    return constrain(bin, 0, BACKGROUND_BINS - 1);
+}
+
+int BackgroundMap::binHeading(uint8_t bin) {
+    return SCAN_MIN_ANGLE + bin * BACKGROUND_BIN_DEGREES;
+}
+
+int BackgroundMap::address(uint8_t bin, uint8_t channel) {
+    return BACKGROUND_EEPROM_ADDRESS + BACKGROUND_HEADER_SIZE + bin * SENSOR_COUNT + channel;
+}
+
+void BackgroundMap::apply(int heading, FlameTriangulation& flameSensor) {
+    uint8_t bin = binOf(heading);
+    if (bin == appliedBin) return;
+    appliedBin = bin;
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        int8_t units = (int8_t)EEPROM.read(address(bin, ch));
+        flameSensor.setBackground(ch, (int)units << BACKGROUND_UNIT_SHIFT);
+    }
+}
+
+void BackgroundMap::learn(int heading, FlameTriangulation& flameSensor) {
+    uint8_t bin = binOf(heading);
+    if (bin != learnBin) {
+        commitLearning(flameSensor);
+        learnBin = bin;
+        learnFrames = 0;
+        for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) learnSums[ch] = 0;
+    }
+    // One detection spoils the whole pass: a flame ramping up at the edge
+    // of the view must not be learned as background
+    if (learnFrames < 0) return;
+    if (!flameSensor.isQuiet()) {
+        learnFrames = -1;
+        return;
+    }
+    if (learnFrames >= BACKGROUND_LEARN_MAX_FRAMES) return;
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) learnSums[ch] += flameSensor.getBackgroundResidual(ch);
+    learnFrames++;
+}
+
+// Moves the bin just left one unit towards the mean residual of the pass,
+// on channels in use whose residual is past the deadband. Quiet learning
+// never takes a bin beyond BACKGROUND_LEARN_LIMIT; only a survey does.
+void BackgroundMap::commitLearning(FlameTriangulation& flameSensor) {
+    if (learnBin >= BACKGROUND_BINS || learnFrames < BACKGROUND_LEARN_FRAMES) return;
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        if (!(flameSensor.getChannelMask() & (1 << ch))) continue;
+        int residual = learnSums[ch] / learnFrames;
+        int units = (int8_t)EEPROM.read(address(learnBin, ch));
+        int limit = (BACKGROUND_LEARN_LIMIT << ADC_OVERSAMPLE_BITS) >> BACKGROUND_UNIT_SHIFT;
+        if (residual > (BACKGROUND_LEARN_DEADBAND << ADC_OVERSAMPLE_BITS) && units < limit) {
+            units++;
+        } else if (residual < -(BACKGROUND_LEARN_DEADBAND << ADC_OVERSAMPLE_BITS) && units > -limit) {
+            units--;
+        } else {
+            continue;
+        }
+        EEPROM.update(address(learnBin, ch), (uint8_t)(int8_t)units);
+        if (learnBin == appliedBin) appliedBin = 0xFF;
+    }
+}
+
+void BackgroundMap::store(uint8_t bin, const int offsets[]) {
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        // Rounded to the nearest unit
+        const int unit = 1 << BACKGROUND_UNIT_SHIFT;
+        int units = (offsets[ch] + (offsets[ch] >= 0 ? unit / 2 : -unit / 2)) / unit;
+        EEPROM.update(address(bin, ch), (uint8_t)(int8_t)constrain(units, -127, 127));
+    }
+    if (bin == appliedBin) appliedBin = 0xFF;
+}
+
+void BackgroundMap::noteFire(int heading) {
+    if (heading == fireBearing) return;
+    fireBearing = heading;
+    firePending = true;
+}
+
+void BackgroundMap::saveFire() {
+    if (!firePending) return;
+    EEPROM.update(BACKGROUND_FIRE_ADDRESS, fireBearing);
+    firePending = false;
+}
+
+int BackgroundMap::getFireBearing() const {
+    return fireBearing == NO_FIRE_BEARING ? -1 : fireBearing;
+}
+
+void BackgroundMap::saveBaseline(const int levels[]) {
+    int16_t baseline[SENSOR_COUNT];
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) baseline[ch] = levels[ch];
+    EEPROM.put(BACKGROUND_BASELINE_ADDRESS, baseline);
+}
+
+bool BackgroundMap::getBaseline(int levels[]) const {
+    int16_t baseline[SENSOR_COUNT];
+    EEPROM.get(BACKGROUND_BASELINE_ADDRESS, baseline);
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        if (baseline[ch] == NO_BASELINE) return false;
+        levels[ch] = baseline[ch];
+    }
+    return true;
+}
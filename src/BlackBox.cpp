@@ -0,0 +1,110 @@
+#include "../include/BlackBox.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_SYSTEM
+
+BlackBox::BlackBox()
+    : head(0), count(0), postRemaining(0), triggered(false), frozen(false),
+      dumpLine(-1), lastRecord(0) {}
+
+void BlackBox::begin() {
+    eventBus.subscribe(EVENT_MASK(EVENT_FLAME_START), handleEvent, this);
+}
+
+void BlackBox::handleEvent(const Event& event, void* context) {
+    BlackBox* self = static_cast<BlackBox*>(context);
+    if (self->triggered) return;
+    // The frame recorded next is the trigger frame
+    self->triggered = true;
+    self->postRemaining = BLACKBOX_POST_FRAMES;
+    self->lastRecord = millis() - BLACKBOX_INTERVAL;
+}
+
+void BlackBox::record(FlameTriangulation& flameSensor, bool flameDetected, float angle,
+                      int servoAngle, bool pumpActive) {
+    if (frozen || dumpLine >= 0) return;
+    unsigned long now = millis();
+    if (now - lastRecord < BLACKBOX_INTERVAL) return;
+    lastRecord = now;
+
+    BlackBoxFrame& frame = frames[head];
+    frame.packed = 0;
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        uint32_t reading = flameSensor.getRawReading(ch) >> ADC_OVERSAMPLE_BITS;
+        frame.packed |= (reading & 0x3FF) << (10 * ch);
+    }
+    if (flameDetected) frame.packed |= BLACKBOX_FLAG_FLAME;
+    if (pumpActive) frame.packed |= BLACKBOX_FLAG_PUMP;
+    frame.angle = flameDetected ? (int8_t)constrain((int)round(angle), -90, 90) : 0;
+    frame.servo = (uint8_t)constrain(servoAngle, 0, 180);
+
+    head = (head + 1) % BLACKBOX_FRAMES;
+    if (count < BLACKBOX_FRAMES) count++;
+
+    if (triggered) {
+        if (postRemaining == 0) {
+            frozen = true;
+            LOG_INFO(F("Black box frozen, send 'dump' to read it"));
+        } else {
+            postRemaining--;
+        }
+    }
+}
+
+void BlackBox::rearm() {
+    triggered = false;
+    frozen = false;
+}
+
+void BlackBox::startDump() {
+    dumpLine = 0;
+}
+
+const BlackBoxFrame& BlackBox::frameAt(uint8_t index) const {
+    return frames[(head + BLACKBOX_FRAMES - count + index) % BLACKBOX_FRAMES];
+}
+
+// Every line fits in a log line (the column header, 45 bytes with its
+// line end, is the longest), so hasRoom() means the next one goes out whole
+void BlackBox::serviceDump() {
+    while (dumpLine >= 0 && logger.hasRoom()) {
+        if (!LOG_ENABLED(LOG_LEVEL_INFO)) {
+            dumpLine = -1;
+            return;
+        }
+        if (dumpLine == 0) {
+            LOG_INFO(F("blackbox: "), frozen ? F("frozen") : F("live"), F(", "), count, F(" frames, "),
+                     BLACKBOX_INTERVAL, F(" ms apart"));
+        } else if (dumpLine == 1) {
+            LOG_INFO(F("ms,right,left,middle,angle,servo,flame,pump"));
+        } else if (dumpLine - 2 < count) {
+            printFrame(dumpLine - 2);
+        } else {
+            LOG_INFO(F("end"));
+            dumpLine = -1;
+            return;
+        }
+        dumpLine++;
+    }
+}
+
+// Time is relative to the trigger frame when frozen, to the newest otherwise
+void BlackBox::printFrame(uint8_t index) const {
+    const BlackBoxFrame& frame = frameAt(index);
+    int reference = frozen ? count - 1 - BLACKBOX_POST_FRAMES : count - 1;
+    LogLine out;
+    out.print((long)(index - reference) * BLACKBOX_INTERVAL);
+    for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+        out.print(',');
+        out.print((unsigned int)((frame.packed >> (10 * ch)) & 0x3FF));
+    }
+    out.print(',');
+    out.print(frame.angle);
+    out.print(',');
+    out.print(frame.servo);
+    out.print(',');
+    out.print((frame.packed & BLACKBOX_FLAG_FLAME) ? 1 : 0);
+    out.print(',');
+    out.print((frame.packed & BLACKBOX_FLAG_PUMP) ? 1 : 0);
+    logger.commit(out);
+}
@@ -1,9 +1,92 @@
 #include "../include/Buzzer.h"
+#include "../include/EventBus.h"
+
+// Handle flame and calibration transitions published on the event bus
+static void handleBuzzerEvent(const Event& event, void* context) {
+  if (event.type == EVENT_FLAME_END) {
+    // Silence the buzzer once, on the falling edge
+    noTone(BUZZER_PIN);
+  } else if (event.type == EVENT_CALIBRATION_NEEDED) {
+    playCalibrationWarningTone();
+  } else if (event.type == EVENT_SENSOR_FAULT) {
+    playSensorFaultTone();
+  }
+}
+
+// Tone sequences: each note sounds for length milliseconds, the next one
+// starts after step milliseconds
+struct MelodyNote {
+  uint16_t frequency;
+  uint8_t length;
+  uint16_t step;
+};
+
+static const MelodyNote startupMelody[] PROGMEM = {
+  { 1175, 100, 110 },  // D
+  { 1175, 100, 120 },  // D
+  { 2349, 100, 220 },  // D^
+  { 1760, 100, 420 },  // A
+  { 1661, 100, 220 },  // G#
+  { 1568, 100, 220 },  // G
+  { 1397, 100, 220 },  // F
+  { 1175, 100, 120 },  // D
+  { 1397, 100, 120 },  // F
+  { 1568, 100, 120 }   // G
+};
+
+// Double beep: calibration needed
+static const MelodyNote calibrationWarning[] PROGMEM = {
+  { 2000, 50, 70 },
+  { 2000, 50, 70 }
+};
+
+// Triple low beep: a flame sensor was taken out of use
+static const MelodyNote sensorFault[] PROGMEM = {
+  { 800, 80, 120 },
+  { 800, 80, 120 },
+  { 800, 80, 120 }
+};
+
+#define MELODY_COUNT(notes) (sizeof(notes) / sizeof(notes[0]))
+#define MELODY_IDLE 0xFF
+
+static const MelodyNote* melody = nullptr;
+static uint8_t melodyLength = 0;
+static uint8_t melodyIndex = MELODY_IDLE;
+static unsigned long melodyNoteStart = 0;
+
+static void startMelodyNote() {
+  tone(BUZZER_PIN, pgm_read_word(&melody[melodyIndex].frequency), pgm_read_byte(&melody[melodyIndex].length));
+  melodyNoteStart = millis();
+}
+
+// Replaces whatever sequence is playing; updateBuzzer() steps through it
+static void startMelody(const MelodyNote* notes, uint8_t length) {
+  melody = notes;
+  melodyLength = length;
+  melodyIndex = 0;
+  startMelodyNote();
+}
+
+// Start the next note of the sequence when the current one is done
+static void updateMelody() {
+  if (melodyIndex == MELODY_IDLE) return;
+  if (millis() - melodyNoteStart < pgm_read_word(&melody[melodyIndex].step)) return;
+  if (++melodyIndex < melodyLength) {
+    startMelodyNote();
+  } else {
+    melodyIndex = MELODY_IDLE;
+    noTone(BUZZER_PIN);
+  }
+}
 
 // Initialize buzzer pin
 void initializeBuzzer() {
   pinMode(BUZZER_PIN, OUTPUT);
   noTone(BUZZER_PIN);
+  eventBus.subscribe(EVENT_MASK(EVENT_FLAME_END) | EVENT_MASK(EVENT_CALIBRATION_NEEDED) |
+                     EVENT_MASK(EVENT_SENSOR_FAULT),
+                     handleBuzzerEvent, nullptr);
 }
 
 // Function to update buzzer based on detection status
@@ -12,6 +95,9 @@ void updateBuzzer(bool flameDetected) {
   static bool sirenState = false;
   
   if (flameDetected) {
+    // The siren takes over from any tone sequence
+    melodyIndex = MELODY_IDLE;
+
     // Create a siren effect - alternating between two frequencies
     const unsigned int lowFreq = 800;  // Low siren tone
     const unsigned int highFreq = 2000; // High siren tone
@@ -34,9 +120,9 @@ void updateBuzzer(bool flameDetected) {
     // Adjust LED blink rate to match siren (optional)
     // digitalWrite(LED_STATUS, sirenState);
   } else {
-    // No flame detected - silence the buzzer
-    noTone(BUZZER_PIN);
+    updateMelody();
   }
+  // Silencing is handled by the EVENT_FLAME_END handler
 }
 
 // Function to play a tone for a specific duration
@@ -46,45 +132,13 @@ void playTone(unsigned int frequency, unsigned long duration) {
   noTone(BUZZER_PIN);
 }
 
-// Play a startup sequence
+// Start the startup melody; updateBuzzer() plays it without blocking
 void playStartupSequence() {
-  // Note durations
-  const int sixteenth = 100;
-  const int eighth = 200;
-  const int quarter = 400;
-  const int halfnote = 800;
-  const int gap = 20;
-  
-  playTone(1175, sixteenth); // D
-  delay(gap/2);
-  playTone(1175, sixteenth); // D
-  delay(gap);
-  
-  playTone(2349, sixteenth); // D^
-  delay(gap + sixteenth);
-  
-  playTone(1760, sixteenth); // A
-  delay(gap + eighth + sixteenth);
-  
-  playTone(1661, sixteenth); // G#
-  delay(gap + sixteenth);
-  
-  playTone(1568, sixteenth); // G
-  delay(gap + sixteenth);
-  
-  playTone(1397, sixteenth); // F
-  delay(gap + sixteenth);
-  
-  playTone(1175, sixteenth); // D
-  delay(gap);
-  
-  playTone(1397, sixteenth); // F
-  delay(gap);
-  
-  playTone(1568, sixteenth); // G
-  delay(gap);
-  
-  noTone(BUZZER_PIN);
+  startMelody(startupMelody, MELODY_COUNT(startupMelody));
+}
+
+bool isBuzzerSequencePlaying() {
+  return melodyIndex != MELODY_IDLE;
 }
 
 // Play calibration tone
@@ -108,12 +162,12 @@ void playCalibrationFinishedTone() {
   noTone(BUZZER_PIN);
 }
 
-// Play calibration warning tone (double beep)
+// Play calibration warning tone (double beep); non-blocking
 void playCalibrationWarningTone() {
-  // Short double beep to alert user about needed calibration
-  tone(BUZZER_PIN, 2000, 50);
-  delay(70);
-  tone(BUZZER_PIN, 2000, 50);
-  delay(70);
-  noTone(BUZZER_PIN);
-} 
\ No newline at end of file
+  startMelody(calibrationWarning, MELODY_COUNT(calibrationWarning));
+}
+
+// Play sensor fault tone (triple low beep); non-blocking
+void playSensorFaultTone() {
+  startMelody(sensorFault, MELODY_COUNT(sensorFault));
+}
@@ -0,0 +1,48 @@
+#include "../include/ClimateFusion.h"
+#include "../include/LCD.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_DETECTION
+
+ClimateFusion::ClimateFusion() : temperatureTrack{0, 0}, humidityTrack{0, 0}, seeded(false), heatCues(0) {}
+
+void ClimateFusion::update(bool flameDetected, FlameTriangulation& flameSensor) {
+    if (flameDetected || !updateDHTReadings()) return;
+    flameSensor.setHeatCues(observe(getTemperature(), getHumidity()));
+}
+
+static int tenths(float value) {
+    return (int)(value * 10 + (value >= 0 ? 0.5 : -0.5));
+}
+
+// EMA as a running sum, as FlameTriangulation::updateAmbientTrack
+static void updateTrack(ClimateTrack& track, int value, bool seed) {
+    if (seed) {
+        track.fast = value << CLIMATE_FAST_SHIFT;
+        track.slow = value << CLIMATE_SLOW_SHIFT;
+        return;
+    }
+    track.fast += value - (track.fast >> CLIMATE_FAST_SHIFT);
+    track.slow += value - (track.slow >> CLIMATE_SLOW_SHIFT);
+}
+
+uint8_t ClimateFusion::observe(float temperature, float humidity) {
+    updateTrack(temperatureTrack, constrain(tenths(temperature), -400, 800), !seeded);
+    updateTrack(humidityTrack, constrain(tenths(humidity), 0, 1000), !seeded);
+    seeded = true;
+    heatCues = (getRise() >= HEAT_RISE_LIMIT ? 1 : 0) + (getHumidityDrop() >= HUMIDITY_DROP_LIMIT ? 1 : 0);
+    return heatCues;
+}
+
+int ClimateFusion::getRise() const {
+    return (temperatureTrack.fast >> CLIMATE_FAST_SHIFT) - (temperatureTrack.slow >> CLIMATE_SLOW_SHIFT);
+}
+
+int ClimateFusion::getHumidityDrop() const {
+    return (humidityTrack.slow >> CLIMATE_SLOW_SHIFT) - (humidityTrack.fast >> CLIMATE_FAST_SHIFT);
+}
+
+void ClimateFusion::printStatus() {
+    LOG_DEBUG(F("Heat cues: "), heatCues, F(" (rise "), logFloat(getRise() / 10.0, 1),
+              F(" C, humidity drop "), logFloat(getHumidityDrop() / 10.0, 1), F(" %)"));
+}
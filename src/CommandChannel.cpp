@@ -0,0 +1,136 @@
+#include "../include/CommandChannel.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_SYSTEM
+
+CommandChannel::CommandChannel(SettingsRegistry& settingsRegistry, BlackBox& blackBox, IncidentTimeline& timeline)
+    : registry(settingsRegistry), blackBox(blackBox), timeline(timeline), length(0), overflow(false), listIndex(-1) {}
+
+bool CommandChannel::poll() {
+    while (listIndex >= 0 && logger.hasRoom()) {
+        printSetting(listIndex);
+        if (++listIndex >= registry.count()) listIndex = -1;
+    }
+    bool changed = false;
+    // Until a reply is sure to fit, input waits in the receive buffer
+    while (listIndex < 0 && logger.hasRoom() && Serial.available() > 0) {
+        char c = Serial.read();
+        if (c == '\n' || c == '\r') {
+            if (overflow) {
+                LOG_INFO(F("error: line too long"));
+            } else if (length > 0) {
+                buffer[length] = '\0';
+                if (execute(buffer)) changed = true;
+            }
+            length = 0;
+            overflow = false;
+        } else if (length < COMMAND_BUFFER_SIZE - 1) {
+            buffer[length++] = c;
+        } else {
+            overflow = true;
+        }
+    }
+    return changed;
+}
+
+// Splits the line in place at whitespace
+char* CommandChannel::nextToken(char*& cursor) {
+    while (*cursor == ' ' || *cursor == '\t') cursor++;
+    if (*cursor == '\0') return NULL;
+    char* token = cursor;
+    while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t') cursor++;
+    if (*cursor != '\0') *cursor++ = '\0';
+    return token;
+}
+
+void CommandChannel::printSetting(uint8_t index) {
+    if (!LOG_ENABLED(LOG_LEVEL_INFO)) return;
+    LogLine out;
+    registry.print(index, out);
+    logger.commit(out);
+}
+
+bool CommandChannel::execute(char* line) {
+    char* cursor = line;
+    char* command = nextToken(cursor);
+    char* name = nextToken(cursor);
+    char* value = nextToken(cursor);
+
+    if (strcmp_P(command, PSTR("get")) == 0) {
+        if (!name) {
+            listIndex = 0;
+            return false;
+        }
+        int index = registry.find(name);
+        if (index < 0) LOG_INFO(F("error: unknown setting"));
+        else printSetting(index);
+        return false;
+    }
+#ifdef FIXED_SETTINGS
+    if (strcmp_P(command, PSTR("set")) == 0 || strcmp_P(command, PSTR("save")) == 0 ||
+        strcmp_P(command, PSTR("load")) == 0 || strcmp_P(command, PSTR("defaults")) == 0) {
+        (void)value;
+        LOG_INFO(F("error: settings are fixed in this build"));
+        return false;
+    }
+#else
+    if (strcmp_P(command, PSTR("set")) == 0) {
+        if (!name || !value) {
+            LOG_INFO(F("usage: set <name> <value>"));
+            return false;
+        }
+        int index = registry.find(name);
+        if (index < 0) {
+            LOG_INFO(F("error: unknown setting"));
+            return false;
+        }
+        char* end;
+        float number = strtod(value, &end);
+        if (*end != '\0') {
+            LOG_INFO(F("error: not a number"));
+            return false;
+        }
+        if (!registry.set(index, number)) {
+            LOG_INFO(F("error: out of range"));
+            return false;
+        }
+        printSetting(index);
+        return true;
+    }
+    if (strcmp_P(command, PSTR("save")) == 0) {
+        registry.save();
+        LOG_INFO(F("ok: saved"));
+        return false;
+    }
+    if (strcmp_P(command, PSTR("load")) == 0) {
+        if (registry.load()) LOG_INFO(F("ok: loaded"));
+        else LOG_INFO(F("error: no saved settings, defaults restored"));
+        return true;
+    }
+    if (strcmp_P(command, PSTR("defaults")) == 0) {
+        registry.restoreDefaults();
+        LOG_INFO(F("ok: defaults restored"));
+        return true;
+    }
+#endif
+    if (strcmp_P(command, PSTR("dump")) == 0) {
+        blackBox.startDump();
+        return false;
+    }
+    if (strcmp_P(command, PSTR("rearm")) == 0) {
+        blackBox.rearm();
+        LOG_INFO(F("ok: black box rearmed"));
+        return false;
+    }
+    if (strcmp_P(command, PSTR("kpi")) == 0) {
+        if (name && strcmp_P(name, PSTR("clear")) == 0) {
+            timeline.clearStats();
+            LOG_INFO(F("ok: incident statistics cleared"));
+        } else {
+            timeline.startPrint();
+        }
+        return false;
+    }
+    LOG_INFO(F("commands: get, set, save, load, defaults, dump, rearm, kpi"));
+    return false;
+}
@@ -0,0 +1,28 @@
+#include "../include/EventBus.h"
+
+EventBus eventBus;
+
+EventBus::EventBus() : subscriberCount(0), publishCount(0) {}
+
+bool EventBus::subscribe(uint8_t eventMask, EventHandler handler, void* context) {
+    if (subscriberCount >= EVENT_BUS_MAX_SUBSCRIBERS || handler == nullptr) return false;
+    subscriptions[subscriberCount].eventMask = eventMask;
+    subscriptions[subscriberCount].handler = handler;
+    subscriptions[subscriberCount].context = context;
+    subscriberCount++;
+    return true;
+}
+
+void EventBus::publish(EventType type, float value) {
+    Event event = { type, value };
+    uint8_t mask = EVENT_MASK(type);
+    publishCount++;
+    // Dispatch synchronously, in subscription order
+    for (uint8_t i = 0; i < subscriberCount; i++) {
+        if (subscriptions[i].eventMask & mask) {
+            subscriptions[i].handler(event, subscriptions[i].context);
+        }
+    }
+}
+
+unsigned long EventBus::getPublishCount() const { return publishCount; }
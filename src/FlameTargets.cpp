@@ -0,0 +1,95 @@
+#include "../include/FlameTargets.h"
+
+FlameTargetList::FlameTargetList() : targetCount(0) {}
+
+void FlameTargetList::observe(int bearing, float strength) {
+    unsigned long now = millis();
+    int index = find(bearing);
+    if (index < 0) {
+        if (targetCount < MAX_FLAME_TARGETS) {
+            index = targetCount++;
+        } else {
+            // Replace the weakest target if the new peak is stronger
+            index = 0;
+            for (int i = 1; i < targetCount; i++) {
+                if (targets[i].strength < targets[index].strength) index = i;
+            }
+            if (targets[index].strength >= strength) return;
+        }
+        targets[index].serviced = false;
+        targets[index].strength = 0;
+    }
+    // The strongest observation of a flame defines its bearing; weaker
+    // ones (flanks of the lobe) only refresh it
+    if (strength >= targets[index].strength) {
+        targets[index].bearing = bearing;
+        targets[index].strength = strength;
+        // A refined bearing can land next to another entry that was opened
+        // on the flank of the same flame; fold it in
+        for (int i = targetCount - 1; i >= 0; i--) {
+            if (i == index || abs(targets[i].bearing - bearing) > TARGET_MERGE_DEGREES) continue;
+            targets[index].serviced = targets[index].serviced && targets[i].serviced;
+            remove(i);
+            if (i < index) index--;
+        }
+    }
+    targets[index].lastSeen = now;
+}
+
+void FlameTargetList::touch(int bearing) {
+    int index = find(bearing);
+    if (index >= 0) targets[index].lastSeen = millis();
+}
+
+void FlameTargetList::expire(unsigned long timeout) {
+    unsigned long now = millis();
+    for (int i = targetCount - 1; i >= 0; i--) {
+        if (now - targets[i].lastSeen > timeout) remove(i);
+    }
+}
+
+void FlameTargetList::remove(int index) {
+    if (index < 0 || index >= targetCount) return;
+    for (int i = index; i < targetCount - 1; i++) {
+        targets[i] = targets[i + 1];
+    }
+    targetCount--;
+}
+
+void FlameTargetList::clear() { targetCount = 0; }
+
+int FlameTargetList::find(int bearing) const {
+    int best = -1;
+    int bestDistance = TARGET_MERGE_DEGREES + 1;
+    for (int i = 0; i < targetCount; i++) {
+        int distance = abs(targets[i].bearing - bearing);
+        if (distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+int FlameTargetList::highestPriority() {
+    // Strongest target that has not had its turn; start a new round
+    // once every target has been serviced
+    for (int round = 0; round < 2; round++) {
+        int best = -1;
+        for (int i = 0; i < targetCount; i++) {
+            if (targets[i].serviced) continue;
+            if (best < 0 || targets[i].strength > targets[best].strength) best = i;
+        }
+        if (best >= 0) return best;
+        for (int i = 0; i < targetCount; i++) targets[i].serviced = false;
+    }
+    return -1;
+}
+
+void FlameTargetList::markServiced(int index) {
+    if (index >= 0 && index < targetCount) targets[index].serviced = true;
+}
+
+int FlameTargetList::count() const { return targetCount; }
+
+const FlameTarget& FlameTargetList::get(int index) const { return targets[index]; }
@@ -1,10 +1,24 @@
 #include "../include/FlameTriangulation.h"
+#include "../include/BearingTable.h"
+#include "../include/IncidentTimeline.h"
+#include "../include/Log.h"
 
-FlameTriangulation::FlameTriangulation() {
+#define LOG_MODULE LOG_DETECTION
+
+#ifdef FIXED_SETTINGS
+FlameTriangulation::FlameTriangulation(const DetectionSettings&) {
+#else
+FlameTriangulation::FlameTriangulation(const DetectionSettings& settings) : config(settings) {
+#endif
   // Initialize ambient levels
-  ambientLevel1 = 1023;
-  ambientLevel2 = 1023;
-  ambientLevel3 = 1023;
+  ambientLevel1 = ADC_SAMPLE_MAX;
+  ambientLevel2 = ADC_SAMPLE_MAX;
+  ambientLevel3 = ADC_SAMPLE_MAX;
+  
+  // No background until BackgroundMap provides one
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) backgroundOffset[ch] = 0;
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) calibratedLevel[ch] = ADC_SAMPLE_MAX;
+  timeline = nullptr;
   
   // Initialize readings
   rawReading1 = 0;
@@ -23,14 +37,28 @@ FlameTriangulation::FlameTriangulation() {
   }
   
   // Initialize ambient tracking variables
-  avgAmbient1 = 1023;
-  avgAmbient2 = 1023;
-  avgAmbient3 = 1023;
+  resetAmbientTrack(ambientTrack1, ADC_SAMPLE_MAX);
+  resetAmbientTrack(ambientTrack2, ADC_SAMPLE_MAX);
+  resetAmbientTrack(ambientTrack3, ADC_SAMPLE_MAX);
   lastAmbientUpdate = 0;
   validSampleCount = 0;
   cooldownEndTime = 0;
   calibrationNeeded = false;
   calibrationWarningTriggered = false;
+  
+  channelMask = ALL_SENSORS_MASK;
+  heatCues = 0;
+  
+  // Initialize noise statistics
+  resetNoiseStats(noise1, ADC_SAMPLE_MAX);
+  resetNoiseStats(noise2, ADC_SAMPLE_MAX);
+  resetNoiseStats(noise3, ADC_SAMPLE_MAX);
+  updateDetectionThresholds();
+  
+  // Initialize peak extraction
+  inPeak = false;
+  peakHeading = 0;
+  peakIntensity = 0;
 }
 
 void FlameTriangulation::calibrate(int reading1, int reading2, int reading3) {
@@ -38,6 +66,9 @@ void FlameTriangulation::calibrate(int reading1, int reading2, int reading3) {
   ambientLevel1 = reading1;
   ambientLevel2 = reading2;
   ambientLevel3 = reading3;
+  calibratedLevel[0] = reading1;
+  calibratedLevel[1] = reading2;
+  calibratedLevel[2] = reading3;
   
   // Reset buffers
   for (int i = 0; i < bufferSize; i++) {
@@ -45,14 +76,28 @@ void FlameTriangulation::calibrate(int reading1, int reading2, int reading3) {
     readingBuffer2[i] = reading2;
     readingBuffer3[i] = reading3;
   }
+  // Until the next frame arrives the sensors read the baseline; left at
+  // their power-on zero they would look like a flame on every channel
+  processedReading1 = reading1;
+  processedReading2 = reading2;
+  processedReading3 = reading3;
+  rawReading1 = reading1 + backgroundOffset[0];
+  rawReading2 = reading2 + backgroundOffset[1];
+  rawReading3 = reading3 + backgroundOffset[2];
   
   // Reset ambient tracking
-  avgAmbient1 = reading1;
-  avgAmbient2 = reading2;
-  avgAmbient3 = reading3;
+  resetAmbientTrack(ambientTrack1, reading1);
+  resetAmbientTrack(ambientTrack2, reading2);
+  resetAmbientTrack(ambientTrack3, reading3);
   validSampleCount = 0;
   calibrationNeeded = false;
   calibrationWarningTriggered = false;
+  
+  // Restart noise statistics around the new baseline
+  resetNoiseStats(noise1, reading1);
+  resetNoiseStats(noise2, reading2);
+  resetNoiseStats(noise3, reading3);
+  updateDetectionThresholds();
 }
 
 void FlameTriangulation::updateReadings(int reading1, int reading2, int reading3) {
@@ -61,8 +106,9 @@ void FlameTriangulation::updateReadings(int reading1, int reading2, int reading3
   rawReading2 = reading2;
   rawReading3 = reading3;
   
-  // Update buffers
-  updateBuffers(reading1, reading2, reading3);
+  // Update buffers with the heading's background removed
+  updateBuffers(reading1 - backgroundOffset[0], reading2 - backgroundOffset[1],
+                reading3 - backgroundOffset[2]);
   
   // Get smoothed readings
   processedReading1 = getSmoothedReading(readingBuffer1);
@@ -72,6 +118,7 @@ void FlameTriangulation::updateReadings(int reading1, int reading2, int reading3
   // Update ambient tracking (pass current flame detection status)
   bool flameDetected = isFlameDetected(); 
   updateAmbientTracking(flameDetected);
+  if (timeline) timeline->observeFrame(isRawSampleAboveThreshold(), flameDetected);
 }
 
 void FlameTriangulation::updateBuffers(int r1, int r2, int r3) {
@@ -96,33 +143,101 @@ int FlameTriangulation::getSmoothedReading(int buffer[]) {
 bool FlameTriangulation::isFlameDetected() {
   // Check if any sensor reading is significantly below ambient level
   return (
-    (ambientLevel1 - processedReading1 > threshold) ||
-    (ambientLevel2 - processedReading2 > threshold) ||
-    (ambientLevel3 - processedReading3 > threshold)
+    (channelEnabled(0) && ambientLevel1 - processedReading1 > detectThreshold1) ||
+    (channelEnabled(1) && ambientLevel2 - processedReading2 > detectThreshold2) ||
+    (channelEnabled(2) && ambientLevel3 - processedReading3 > detectThreshold3)
   );
 }
 
+bool FlameTriangulation::isRawSampleAboveThreshold() {
+  // Unsmoothed check used to wake from idle on the very first sample
+  return (
+    (channelEnabled(0) && ambientLevel1 + backgroundOffset[0] - rawReading1 > detectThreshold1) ||
+    (channelEnabled(1) && ambientLevel2 + backgroundOffset[1] - rawReading2 > detectThreshold2) ||
+    (channelEnabled(2) && ambientLevel3 + backgroundOffset[2] - rawReading3 > detectThreshold3)
+  );
+}
+
+void FlameTriangulation::getChannelState(uint8_t channel, int& processed, int& ambient, int& threshold) {
+  switch (channel) {
+    case 0: processed = processedReading1; ambient = ambientLevel1; threshold = detectThreshold1; break;
+    case 1: processed = processedReading2; ambient = ambientLevel2; threshold = detectThreshold2; break;
+    default: processed = processedReading3; ambient = ambientLevel3; threshold = detectThreshold3; break;
+  }
+}
+
+int FlameTriangulation::getDetectionThreshold(uint8_t channel) {
+  int processed, ambient, threshold;
+  getChannelState(channel, processed, ambient, threshold);
+  return threshold;
+}
+
+int FlameTriangulation::getRawReading(uint8_t channel) {
+  switch (channel) {
+    case 0: return rawReading1;
+    case 1: return rawReading2;
+    default: return rawReading3;
+  }
+}
+
+float FlameTriangulation::getChannelIntensity(uint8_t channel) {
+  int processed, ambient, threshold;
+  getChannelState(channel, processed, ambient, threshold);
+  return calculateRelativeIntensity(processed, ambient);
+}
+
+bool FlameTriangulation::isChannelDetecting(uint8_t channel) {
+  int processed, ambient, threshold;
+  getChannelState(channel, processed, ambient, threshold);
+  return ambient - processed > threshold;
+}
+
+int FlameTriangulation::getBackgroundResidual(uint8_t channel) {
+  int processed, ambient, threshold;
+  getChannelState(channel, processed, ambient, threshold);
+  return getRawReading(channel) - backgroundOffset[channel] - ambient;
+}
+
+bool FlameTriangulation::isQuiet() {
+  return millis() >= cooldownEndTime && !isFlameDetected();
+}
+
+int FlameTriangulation::getCurrentAmbient(uint8_t channel) {
+  switch (channel) {
+    case 0: return getCurrentAmbient1();
+    case 1: return getCurrentAmbient2();
+    default: return getCurrentAmbient3();
+  }
+}
+
+void FlameTriangulation::setChannelMask(uint8_t mask) {
+  channelMask = mask & ALL_SENSORS_MASK;
+}
+
 float FlameTriangulation::calculateRelativeIntensity(int reading, int ambient) {
   // Convert reading to relative intensity (0.0 - 1.0)
   int diff = ambient - reading;
   if (diff <= 0) return 0.0;
   
   // Cap at reasonable maximum
-  const int maxDiff = 500;
-  if (diff > maxDiff) diff = maxDiff;
+  if (diff > maxIntensityDiff) diff = maxIntensityDiff;
   
-  return (float)diff / maxDiff;
+  return diff * (1.0f / maxIntensityDiff);
 }
 
 void FlameTriangulation::updateAmbientTracking(bool flameDetected) {
   // Only update ambient tracking if no flame is detected
   // and we're not in a cooldown period after flame detection
   if (!flameDetected && millis() >= cooldownEndTime) {
-    // Update running average with new readings (exponential moving average)
-    // Use a slow-moving average (0.95/0.05 weights) for stability
-    avgAmbient1 = (avgAmbient1 * 0.95) + (processedReading1 * 0.05);
-    avgAmbient2 = (avgAmbient2 * 0.95) + (processedReading2 * 0.05);
-    avgAmbient3 = (avgAmbient3 * 0.95) + (processedReading3 * 0.05);
+    updateAmbientTrack(ambientTrack1, processedReading1);
+    updateAmbientTrack(ambientTrack2, processedReading2);
+    updateAmbientTrack(ambientTrack3, processedReading3);
+    
+    // Track sensor noise on the same flame-free samples
+    updateNoiseStats(noise1, processedReading1, detectThreshold1);
+    updateNoiseStats(noise2, processedReading2, detectThreshold2);
+    updateNoiseStats(noise3, processedReading3, detectThreshold3);
+    updateDetectionThresholds();
     
     // Increment valid sample counter
     if (validSampleCount < 0xFFFF) {  // Prevent overflow
@@ -135,23 +250,147 @@ void FlameTriangulation::updateAmbientTracking(bool flameDetected) {
   }
 }
 
+void FlameTriangulation::resetAmbientTrack(AmbientTrack& track, int reading) {
+  track.fast = (long)reading << AMBIENT_FAST_SHIFT;
+  track.slow = (long)reading << AMBIENT_SLOW_SHIFT;
+}
+
+// EMA as a running sum: sum += x - sum / 2^shift, the average is sum >> shift
+void FlameTriangulation::updateAmbientTrack(AmbientTrack& track, int reading) {
+  track.fast += reading - (track.fast >> AMBIENT_FAST_SHIFT);
+  track.slow += reading - (track.slow >> AMBIENT_SLOW_SHIFT);
+}
+
+void FlameTriangulation::resetNoiseStats(NoiseStats& stats, int reading) {
+  stats.mean = (long)reading << 4;
+  stats.variance = 0;
+  stats.count = 0;
+  stats.censored = 0;
+}
+
+void FlameTriangulation::updateNoiseStats(NoiseStats& stats, int reading, int threshold) {
+  long x = (long)reading << 4;
+  // Deviations are clamped so a single spike cannot blow up the variance
+  long delta = constrain(x - stats.mean, -NOISE_DELTA_LIMIT, NOISE_DELTA_LIMIT);
+  
+  // Censor samples beyond half the detection threshold: as the head turns
+  // onto a flame the readings ramp down through the sub-threshold band, and
+  // letting that ramp into the noise estimate would raise the threshold
+  // until the flame is no longer detected. Nothing within
+  // NOISE_CENSOR_SIGMAS is cut, which would bias sigma low at small
+  // multipliers. A level that stays out of reach (an ambient step) is taken
+  // as the new mean after NOISE_RESEED_SAMPLES; the variance is kept.
+  if (stats.count >= NOISE_MIN_SAMPLES && abs(delta) > ((long)threshold << 3) &&
+      delta * delta > NOISE_CENSOR_SIGMAS * NOISE_CENSOR_SIGMAS * stats.variance) {
+    if (++stats.censored >= NOISE_RESEED_SAMPLES) {
+      stats.mean = x;
+      stats.censored = 0;
+    }
+    return;
+  }
+  stats.censored = 0;
+  if (stats.count < NOISE_WINDOW) stats.count++;
+  
+  // Welford: var += (delta * delta2 - var) / n, all in fixed point
+  stats.mean += delta / (long)stats.count;
+  long delta2 = constrain(x - stats.mean, -NOISE_DELTA_LIMIT, NOISE_DELTA_LIMIT);
+  stats.variance += (delta * delta2 - stats.variance) / (long)stats.count;
+}
+
+// Integer square root (bitwise)
+static unsigned long isqrt(unsigned long value) {
+  unsigned long result = 0;
+  unsigned long bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+int FlameTriangulation::noiseThreshold(const NoiseStats& stats) {
+  // Each heat cue takes HEAT_THRESHOLD_STEP sixteenths off; the CFAR
+  // floor still holds
+  long sixteenths = 16 - heatCues * HEAT_THRESHOLD_STEP;
+  if (config.noiseMultiplier <= 0 || stats.count < NOISE_MIN_SAMPLES) {
+    return ((long)config.fixedThreshold * sixteenths) >> 4;
+  }
+  // sigma in Q4 counts
+  long sigma = isqrt(stats.variance > 0 ? stats.variance : 0);
+  long threshold = ((long)(config.noiseMultiplier * sigma) * sixteenths) >> 8;
+  return constrain(threshold, (long)minThreshold, (long)maxThreshold);
+}
+
+void FlameTriangulation::updateDetectionThresholds() {
+  detectThreshold1 = noiseThreshold(noise1);
+  detectThreshold2 = noiseThreshold(noise2);
+  detectThreshold3 = noiseThreshold(noise3);
+}
+
+void FlameTriangulation::applySettings() {
+  updateDetectionThresholds();
+}
+
+void FlameTriangulation::setHeatCues(uint8_t cues) {
+  cues = min(cues, (uint8_t)2);
+  if (cues == heatCues) return;
+  heatCues = cues;
+  updateDetectionThresholds();
+}
+
+// Drift is the slow EMA's distance from the calibrated baseline. While the
+// detector is quiet, drift that has settled (fast and slow EMAs agree) and
+// goes the same way, past DRIFT_DEADBAND, on every channel in use is followed: each baseline
+// moves towards its slow EMA by at most REBASELINE_STEP per check (half
+// that for falling readings), and in all no further from the last
+// calibration than FOLLOW_LIMIT (FOLLOW_LIMIT_MORE_IR). Drift that outruns
+// the steps, that is not followed because the channels disagree, or that
+// carries on past the follow limit raises calibrationNeeded; from then on
+// the baseline is left for a manual calibration.
 void FlameTriangulation::updateCalibrationMonitoring() {
   // Only check for drift after collecting enough samples
-  if (validSampleCount >= MIN_SAMPLES_FOR_DRIFT) {
-    // Calculate absolute deviations for each sensor
-    float dev1 = abs(avgAmbient1 - ambientLevel1);
-    float dev2 = abs(avgAmbient2 - ambientLevel2);
-    float dev3 = abs(avgAmbient3 - ambientLevel3);
-    
-    // Check if any sensor has drifted beyond the warning threshold
-    if (dev1 > DRIFT_WARNING_THRESHOLD || 
-        dev2 > DRIFT_WARNING_THRESHOLD || 
-        dev3 > DRIFT_WARNING_THRESHOLD) {
-      
-      calibrationNeeded = true;
-    } else {
-      calibrationNeeded = false;
+  if (validSampleCount < MIN_SAMPLES_FOR_DRIFT) return;
+  
+  const AmbientTrack* tracks[SENSOR_COUNT] = { &ambientTrack1, &ambientTrack2, &ambientTrack3 };
+  int* levels[SENSOR_COUNT] = { &ambientLevel1, &ambientLevel2, &ambientLevel3 };
+  int drift[SENSOR_COUNT];
+  bool follow = isQuiet();
+  bool rising = true, falling = true;
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+    int slow = tracks[ch]->slow >> AMBIENT_SLOW_SHIFT;
+    int fast = tracks[ch]->fast >> AMBIENT_FAST_SHIFT;
+    drift[ch] = slow - *levels[ch];
+    if (!channelEnabled(ch)) continue;
+    if (abs(drift[ch]) > DRIFT_WARNING_THRESHOLD || abs(fast - slow) > AMBIENT_SETTLED_LIMIT) follow = false;
+    if (drift[ch] <= DRIFT_DEADBAND) rising = false;
+    if (drift[ch] >= -DRIFT_DEADBAND) falling = false;
+  }
+  // Ambient light changes move every sensor the same way
+  if (!rising && !falling) follow = false;
+  
+  int stepLimit = falling ? REBASELINE_STEP / 2 : REBASELINE_STEP;
+  int followLimit = falling ? FOLLOW_LIMIT_MORE_IR : FOLLOW_LIMIT;
+  
+  calibrationNeeded = false;
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+    if (!channelEnabled(ch)) continue;
+    int moved = *levels[ch] - calibratedLevel[ch];
+    if (follow) {
+      int step = constrain(drift[ch], -stepLimit, stepLimit);
+      step = constrain(moved + step, -followLimit, followLimit) - moved;
+      *levels[ch] += step;
+      drift[ch] -= step;
+      moved += step;
+      // At the limit and still drifting further away
+      if (abs(moved) >= followLimit && (long)drift[ch] * moved > 0) calibrationNeeded = true;
     }
+    if (abs(drift[ch]) > DRIFT_WARNING_THRESHOLD) calibrationNeeded = true;
   }
 }
 
@@ -161,35 +400,75 @@ void FlameTriangulation::resetCalibrationWarning() {
 }
 
 float FlameTriangulation::getFlameAngle() {
-  // Use different methods based on which sensors detect the flame
-  bool s1Detect = (ambientLevel1 - processedReading1 > threshold);
-  bool s2Detect = (ambientLevel2 - processedReading2 > threshold);
-  bool s3Detect = (ambientLevel3 - processedReading3 > threshold);
-  
-  // If all three sensors detect the flame, use weighted triangulation
-  if (s1Detect && s2Detect && s3Detect) {
-    return weightedAngularTriangulation();
+  // One least-squares fit over every channel in use, so the bearing is
+  // continuous as sensors cross their thresholds. Disabled channels drop
+  // out of the fit.
+  if (!isFlameDetected()) return 0.0;
+  return leastSquaresBearing();
+}
+
+// Fits bearing and power to the channel intensities with the sensor cone
+// model in BearingTable.h. For a unit response vector u(bearing) the best
+// power is the projection m.u, and the residual |m|^2 - (m.u)^2 is
+// smallest where the projection is largest. The best grid entry is refined
+// by a parabola through its neighbours. Past the cones' edges the table
+// repeats one entry (one sensor alone sees the flame); a run of tied
+// entries gives its centre, so a flame seen by the left or the right
+// sensor alone reads the same distance off centre.
+float FlameTriangulation::leastSquaresBearing() {
+  int intensity[SENSOR_COUNT];
+  for (uint8_t channel = 0; channel < SENSOR_COUNT; channel++) {
+    int processed, ambient, threshold;
+    getChannelState(channel, processed, ambient, threshold);
+    intensity[channel] = channelEnabled(channel) ? max(ambient - processed, 0) : 0;
   }
   
-  // If only two sensors detect the flame, use dual sensor method
-  if ((s1Detect && s2Detect) || (s1Detect && s3Detect) || (s2Detect && s3Detect)) {
-    return dualSensorEstimation();
+  int bestIndex = -1, lastIndex = -1;
+  float bestScore = 0;
+  for (uint8_t i = 0; i < BEARING_TABLE_SIZE; i++) {
+    float score = bearingScore(i, intensity);
+    if (score > bestScore) {
+      bestScore = score;
+      bestIndex = i;
+      lastIndex = i;
+    } else if (score == bestScore && lastIndex == i - 1) {
+      lastIndex = i;
+    }
   }
+  if (bestIndex < 0) return 0.0;
+  if (lastIndex > bestIndex) return BEARING_TABLE_MIN + (bestIndex + lastIndex) * 0.5 * BEARING_TABLE_STEP;
   
-  // If only one sensor detects the flame, estimate direction based on that sensor
-  if (s1Detect) return sensorAngleLimit;         // Right sensor
-  if (s2Detect) return -sensorAngleLimit;        // Left sensor
-  if (s3Detect) return 0.0;                      // Middle sensor
-  
-  // Fallback (shouldn't reach here if isFlameDetected() was checked first)
-  return 0.0;
+  float offset = 0;
+  if (bestIndex > 0 && bestIndex < BEARING_TABLE_SIZE - 1) {
+    float before = bearingScore(bestIndex - 1, intensity);
+    float after = bearingScore(bestIndex + 1, intensity);
+    float curvature = before - 2 * bestScore + after;
+    if (curvature < 0) offset = constrain(0.5 * (before - after) / curvature, -0.5, 0.5);
+  }
+  return BEARING_TABLE_MIN + (bestIndex + offset) * BEARING_TABLE_STEP;
+}
+
+// Projection of the intensities onto one table entry. The entries are unit
+// vectors over all three channels; with a channel disabled the vector is
+// renormalized over the remaining ones.
+float FlameTriangulation::bearingScore(uint8_t index, const int intensity[]) {
+  long dot = 0;
+  unsigned long norm = 0;
+  for (uint8_t channel = 0; channel < SENSOR_COUNT; channel++) {
+    if (!channelEnabled(channel)) continue;
+    int gain = pgm_read_word(&BEARING_TABLE[index][channel]);
+    dot += (long)intensity[channel] * gain;
+    norm += (long)gain * gain;
+  }
+  if (channelMask == ALL_SENSORS_MASK) return dot;
+  return norm ? dot * (32767.0 / sqrt((float)norm)) : 0.0;
 }
 
 float FlameTriangulation::dualSensorEstimation() {
   // Calculate relative intensities
-  float i1 = calculateRelativeIntensity(processedReading1, ambientLevel1);
-  float i2 = calculateRelativeIntensity(processedReading2, ambientLevel2);
-  float i3 = calculateRelativeIntensity(processedReading3, ambientLevel3);
+  float i1 = channelEnabled(0) ? calculateRelativeIntensity(processedReading1, ambientLevel1) : 0.0;
+  float i2 = channelEnabled(1) ? calculateRelativeIntensity(processedReading2, ambientLevel2) : 0.0;
+  float i3 = channelEnabled(2) ? calculateRelativeIntensity(processedReading3, ambientLevel3) : 0.0;
   
   // Find the two strongest signals
   if (i1 >= i3 && i2 >= i3) {
@@ -214,9 +493,9 @@ float FlameTriangulation::dualSensorEstimation() {
 
 float FlameTriangulation::weightedAngularTriangulation() {
   // Calculate relative intensities
-  float i1 = calculateRelativeIntensity(processedReading1, ambientLevel1);
-  float i2 = calculateRelativeIntensity(processedReading2, ambientLevel2);
-  float i3 = calculateRelativeIntensity(processedReading3, ambientLevel3);
+  float i1 = channelEnabled(0) ? calculateRelativeIntensity(processedReading1, ambientLevel1) : 0.0;
+  float i2 = channelEnabled(1) ? calculateRelativeIntensity(processedReading2, ambientLevel2) : 0.0;
+  float i3 = channelEnabled(2) ? calculateRelativeIntensity(processedReading3, ambientLevel3) : 0.0;
   
   // Calculate weights
   float totalIntensity = i1 + i2 + i3;
@@ -232,96 +511,125 @@ float FlameTriangulation::weightedAngularTriangulation() {
 }
 
 float FlameTriangulation::getConfidence() {
-  // Calculate relative intensities
-  float i1 = calculateRelativeIntensity(processedReading1, ambientLevel1);
-  float i2 = calculateRelativeIntensity(processedReading2, ambientLevel2);
-  float i3 = calculateRelativeIntensity(processedReading3, ambientLevel3);
-  
-  // Total intensity as base confidence
-  float totalIntensity = i1 + i2 + i3;
-  float baseConfidence = constrain(totalIntensity / 1.5, 0.0, 1.0);
+  // Signal-to-noise ratio of each sensor relative to its detection
+  // threshold (1.0 = just at k * sigma)
+  float snr1 = channelEnabled(0) ? (float)max(ambientLevel1 - processedReading1, 0) / detectThreshold1 : 0.0;
+  float snr2 = channelEnabled(1) ? (float)max(ambientLevel2 - processedReading2, 0) / detectThreshold2 : 0.0;
+  float snr3 = channelEnabled(2) ? (float)max(ambientLevel3 - processedReading3, 0) / detectThreshold3 : 0.0;
   
-  // Adjust confidence based on consistency
-  float consistency = 1.0;
-  if (totalIntensity > 0.1) {
-    // Check if intensity distribution makes sense for a point source
-    // Intensity should decrease as we move away from the flame
-    if ((i1 > i3 && i3 > i2) || (i2 > i3 && i3 > i1)) {
-      consistency = 1.0; // Good pattern
-    } else {
-      consistency = 0.7; // Unexpected pattern
-    }
+  // Independent channels combine in quadrature; a flame at the threshold
+  // of one sensor gives 50%, twice the threshold gives full confidence
+  float combined = sqrt(snr1 * snr1 + snr2 * snr2 + snr3 * snr3);
+  return constrain(combined / 2.0, 0.0, 1.0);
+}
+
+float FlameTriangulation::getTotalIntensity() {
+  float total = 0;
+  for (uint8_t channel = 0; channel < SENSOR_COUNT; channel++) {
+    if (channelEnabled(channel)) total += getChannelIntensity(channel);
   }
-  
-  return baseConfidence * consistency;
+  return total;
 }
 
-void FlameTriangulation::printDebugInfo() {
-  Serial.println(F("------ Sensor Readings ------"));
-  
-  Serial.print(F("Raw: "));
-  Serial.print(rawReading1);
-  Serial.print(F(", "));
-  Serial.print(rawReading2);
-  Serial.print(F(", "));
-  Serial.println(rawReading3);
-  
-  Serial.print(F("Processed: "));
-  Serial.print(processedReading1);
-  Serial.print(F(", "));
-  Serial.print(processedReading2);
-  Serial.print(F(", "));
-  Serial.println(processedReading3);
-  
-  Serial.print(F("Relative Intensity: "));
-  Serial.print(calculateRelativeIntensity(processedReading1, ambientLevel1), 2);
-  Serial.print(F(", "));
-  Serial.print(calculateRelativeIntensity(processedReading2, ambientLevel2), 2);
-  Serial.print(F(", "));
-  Serial.println(calculateRelativeIntensity(processedReading3, ambientLevel3), 2);
-  
-  Serial.print(F("Flame Detected: "));
-  Serial.println(isFlameDetected() ? F("YES") : F("NO"));
-  
-  if (isFlameDetected()) {
-    Serial.print(F("Flame Angle: "));
-    Serial.print(getFlameAngle(), 1);
-    Serial.println(F("°"));
-    
-    Serial.print(F("Confidence: "));
-    Serial.print(getConfidence() * 100, 0);
-    Serial.println(F("%"));
+void FlameTriangulation::observeHeading(int heading) {
+  // Called with the servo heading after each update. As the head sweeps
+  // past a flame the total intensity rises and falls; the heading of the
+  // maximum is the flame's bearing. A dip between two maxima separates
+  // neighbouring flames.
+  if (!isFlameDetected()) {
+    inPeak = false;
+    return;
   }
   
-  // Add ambient tracking debug info
-  if (validSampleCount >= MIN_SAMPLES_FOR_DRIFT) {
-    Serial.println(F("------ Ambient Tracking ------"));
-    Serial.print(F("Current Avg: "));
-    Serial.print(avgAmbient1, 1);
-    Serial.print(F(", "));
-    Serial.print(avgAmbient2, 1);
-    Serial.print(F(", "));
-    Serial.println(avgAmbient3, 1);
-    
-    Serial.print(F("Calibrated: "));
-    Serial.print(ambientLevel1);
-    Serial.print(F(", "));
-    Serial.print(ambientLevel2);
-    Serial.print(F(", "));
-    Serial.println(ambientLevel3);
-    
-    Serial.print(F("Deviation: "));
-    Serial.print(abs(avgAmbient1 - ambientLevel1), 1);
-    Serial.print(F(", "));
-    Serial.print(abs(avgAmbient2 - ambientLevel2), 1);
-    Serial.print(F(", "));
-    Serial.println(abs(avgAmbient3 - ambientLevel3), 1);
-    
-    Serial.print(F("Calibration Needed: "));
-    Serial.println(calibrationNeeded ? F("YES") : F("NO"));
+  float intensity = getTotalIntensity();
+  if (!inPeak || intensity > peakIntensity) {
+    inPeak = true;
+    peakHeading = heading;
+    peakIntensity = intensity;
+    targets.observe(peakHeading, peakIntensity);
+  } else if (intensity < peakIntensity * PEAK_DIP_RATIO) {
+    // Start of a new lobe; it is recorded once it rises to a maximum
+    peakHeading = heading;
+    peakIntensity = intensity;
+  }
+  targets.touch(heading);
+}
+
+void FlameTriangulation::printDebugLine(uint8_t line) {
+  bool tracking = validSampleCount >= MIN_SAMPLES_FOR_DRIFT;
+  switch (line) {
+    case 0:
+      LOG_DEBUG(F("------ Sensor Readings ------"));
+      break;
+    case 1:
+      LOG_DEBUG(F("Raw: "), rawReading1, F(", "), rawReading2, F(", "), rawReading3);
+      break;
+    case 2:
+      LOG_DEBUG(F("Processed: "), processedReading1, F(", "), processedReading2,
+                F(", "), processedReading3);
+      break;
+    case 3:
+      LOG_DEBUG(F("Relative Intensity: "),
+                logFloat(calculateRelativeIntensity(processedReading1, ambientLevel1), 2), F(", "),
+                logFloat(calculateRelativeIntensity(processedReading2, ambientLevel2), 2), F(", "),
+                logFloat(calculateRelativeIntensity(processedReading3, ambientLevel3), 2));
+      break;
+    case 4:
+      LOG_DEBUG(F("Flame Detected: "), isFlameDetected() ? F("YES") : F("NO"));
+      break;
+    case 5:
+      if (isFlameDetected()) LOG_DEBUG(F("Flame Angle: "), logFloat(getFlameAngle(), 1), F("°"));
+      break;
+    case 6:
+      if (isFlameDetected()) LOG_DEBUG(F("Confidence: "), logFloat(getConfidence() * 100, 0), F("%"));
+      break;
+    case 7:
+      // Built piece by piece; targets past the line length are cut
+      if (LOG_ENABLED(LOG_LEVEL_DEBUG) && targets.count() > 0) {
+        LogLine out;
+        out.print(F("Targets (bearing:strength): "));
+        for (int i = 0; i < targets.count(); i++) {
+          if (i > 0) out.print(F(", "));
+          out.print(targets.get(i).bearing);
+          out.print(F(":"));
+          out.print(targets.get(i).strength, 2);
+        }
+        logger.commit(out);
+      }
+      break;
+    case 8:
+      if (tracking) LOG_DEBUG(F("------ Ambient Tracking ------"));
+      break;
+    case 9:
+      if (tracking) {
+        LOG_DEBUG(F("Current Avg (fast/slow): "),
+                  getCurrentAmbient1(), '/', ambientTrack1.slow >> AMBIENT_SLOW_SHIFT, F(", "),
+                  getCurrentAmbient2(), '/', ambientTrack2.slow >> AMBIENT_SLOW_SHIFT, F(", "),
+                  getCurrentAmbient3(), '/', ambientTrack3.slow >> AMBIENT_SLOW_SHIFT);
+      }
+      break;
+    case 10:
+      if (tracking) LOG_DEBUG(F("Calibrated: "), ambientLevel1, F(", "), ambientLevel2, F(", "), ambientLevel3);
+      break;
+    case 11:
+      if (tracking) {
+        LOG_DEBUG(F("Deviation: "), getCurrentAmbient1() - ambientLevel1, F(", "),
+                  getCurrentAmbient2() - ambientLevel2, F(", "), getCurrentAmbient3() - ambientLevel3);
+      }
+      break;
+    case 12:
+      if (tracking) {
+        LOG_DEBUG(F("Threshold: "), detectThreshold1, F(", "), detectThreshold2,
+                  F(", "), detectThreshold3);
+      }
+      break;
+    case 13:
+      if (tracking) LOG_DEBUG(F("Calibration Needed: "), calibrationNeeded ? F("YES") : F("NO"));
+      break;
+    case 14:
+      LOG_DEBUG();
+      break;
   }
-  
-  Serial.println();
 }
 
 // This method is not used in the current implementation,
@@ -0,0 +1,96 @@
+#include "../include/I2cLcd.h"
+#include "../include/LCD.h"
+
+// HD44780 commands
+#define LCD_CLEAR 0x01
+#define LCD_ENTRY_LEFT 0x06
+#define LCD_DISPLAY_ON 0x0C
+#define LCD_FUNCTION_4BIT_2LINE 0x28
+#define LCD_SET_DDRAM 0x80
+
+I2cLcd::I2cLcd(uint8_t addr) : address(addr), backlightBits(LCD_PIN_BACKLIGHT) {}
+
+// Appends the four expander writes for one LCD byte; returns their count
+uint8_t I2cLcd::encode(uint8_t* out, uint8_t value, uint8_t mode) const {
+    uint8_t high = (value & 0xF0) | mode | backlightBits;
+    uint8_t low = (value << 4) | mode | backlightBits;
+    out[0] = high | LCD_PIN_EN;
+    out[1] = high;
+    out[2] = low | LCD_PIN_EN;
+    out[3] = low;
+    return 4;
+}
+
+void I2cLcd::sendWaiting(const uint8_t* data, uint8_t length) {
+    while (!twiQueue.send(address, data, length)) {}
+}
+
+// A write with EN low first settles RS before the enable pulse
+void I2cLcd::command(uint8_t value) {
+    uint8_t frame[5];
+    frame[0] = backlightBits;
+    sendWaiting(frame, 1 + encode(frame + 1, value, 0));
+}
+
+void I2cLcd::initNibble(uint8_t nibble) {
+    uint8_t frame[2] = { (uint8_t)(nibble | backlightBits | LCD_PIN_EN), (uint8_t)(nibble | backlightBits) };
+    sendWaiting(frame, 2);
+    twiQueue.flush();
+}
+
+void I2cLcd::init() {
+    twiQueue.begin(LCD_I2C_FREQUENCY);
+    delay(50);  // Power-on time of the controller
+
+    // Reset into 4-bit mode (HD44780 datasheet, figure 24)
+    initNibble(0x30);
+    delayMicroseconds(4500);
+    initNibble(0x30);
+    delayMicroseconds(4500);
+    initNibble(0x30);
+    delayMicroseconds(150);
+    initNibble(0x20);
+
+    command(LCD_FUNCTION_4BIT_2LINE);
+    command(LCD_DISPLAY_ON);
+    command(LCD_CLEAR);
+    twiQueue.flush();
+    delay(2);  // Clear takes 1.52 ms
+    command(LCD_ENTRY_LEFT);
+    twiQueue.flush();
+}
+
+void I2cLcd::backlight() {
+    backlightBits = LCD_PIN_BACKLIGHT;
+    sendWaiting(&backlightBits, 1);
+}
+
+void I2cLcd::noBacklight() {
+    backlightBits = 0;
+    sendWaiting(&backlightBits, 1);
+}
+
+void I2cLcd::setCursor(uint8_t col, uint8_t row) {
+    command(LCD_SET_DDRAM | (col + (row ? 0x40 : 0)));
+}
+
+bool I2cLcd::writeRow(uint8_t row, const char* text, uint8_t length) {
+    // Cursor command and the characters, each preceded by an RS setup write
+    uint8_t frame[1 + 4 + 1 + 4 * LCD_ROW_MAX];
+    if (length > LCD_ROW_MAX) length = LCD_ROW_MAX;
+    uint8_t n = 0;
+    frame[n++] = backlightBits;
+    n += encode(frame + n, LCD_SET_DDRAM | (row ? 0x40 : 0), 0);
+    frame[n++] = LCD_PIN_RS | backlightBits;
+    for (uint8_t i = 0; i < length; i++) {
+        n += encode(frame + n, text[i], LCD_PIN_RS);
+    }
+    return twiQueue.send(address, frame, n);
+}
+
+size_t I2cLcd::write(uint8_t value) {
+    uint8_t frame[5];
+    frame[0] = LCD_PIN_RS | backlightBits;
+    sendWaiting(frame, 1 + encode(frame + 1, value, LCD_PIN_RS));
+    return 1;
+}
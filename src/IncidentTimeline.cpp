@@ -0,0 +1,169 @@
+#include "../include/IncidentTimeline.h"
+#include "../include/Log.h"
+#include <EEPROM.h>
+
+#define LOG_MODULE LOG_INCIDENT
+
+struct IncidentStatsHeader {
+    uint16_t magic;
+    uint16_t incidents;
+};
+
+struct KpiStats {
+    unsigned long minimum;
+    unsigned long maximum;
+    unsigned long mean;       // Running mean, updated without a sum that could overflow
+    uint16_t count;
+};
+
+static_assert(INCIDENT_EEPROM_ADDRESS + sizeof(IncidentStatsHeader) + INCIDENT_KPI_COUNT * sizeof(KpiStats) <= 1024,
+              "Incident statistics do not fit in EEPROM");
+
+static int statsAddress(uint8_t index) {
+    return INCIDENT_EEPROM_ADDRESS + sizeof(IncidentStatsHeader) + index * sizeof(KpiStats);
+}
+
+IncidentTimeline::IncidentTimeline()
+    : lastRawAbove(0), relayClosedAt(0), relayMicros(0), marked(0), open(false), printLine(-1) {}
+
+void IncidentTimeline::observeFrame(bool rawAboveThreshold, bool detected) {
+    unsigned long now = micros();
+    if (!open) {
+        // The timeline starts at the first raw sample of the run that ends
+        // in a detection; a run that dies out unconfirmed was noise. The
+        // last incident's milestones are kept for `kpi` until then.
+        bool finished = reached(MILESTONE_DETECTED);
+        if (!finished && reached(MILESTONE_ABOVE_THRESHOLD) && !rawAboveThreshold && !detected &&
+            now - lastRawAbove >= TIMELINE_ARM_TIMEOUT) {
+            marked = 0;
+        }
+        if (rawAboveThreshold || detected) {
+            if (finished) marked = 0;
+            lastRawAbove = now;
+            if (!reached(MILESTONE_ABOVE_THRESHOLD)) {
+                marked = 1 << MILESTONE_ABOVE_THRESHOLD;
+                stamps[MILESTONE_ABOVE_THRESHOLD] = now;
+            }
+        }
+        if (!detected) return;
+        open = true;
+        relayMicros = 0;
+        mark(MILESTONE_DETECTED);
+    }
+    if (detected) {
+        stamps[MILESTONE_LAST_DETECTION] = now;
+        marked |= 1 << MILESTONE_LAST_DETECTION;
+    }
+}
+
+void IncidentTimeline::mark(Milestone milestone) {
+    if (!open || reached(milestone)) return;
+    stamps[milestone] = micros();
+    marked |= 1 << milestone;
+}
+
+void IncidentTimeline::relay(bool closed) {
+    unsigned long now = micros();
+    if (closed) {
+        mark(MILESTONE_RELAY);
+        relayClosedAt = now;
+    } else if (open) {
+        relayMicros += now - relayClosedAt;
+    }
+}
+
+void IncidentTimeline::close() {
+    if (!open) return;
+    open = false;
+    updateStats();
+    startPrint();
+}
+
+// KPI index: the milestones after the first, then the relay on-time
+bool IncidentTimeline::kpi(uint8_t index, unsigned long& value) const {
+    if (index == INCIDENT_KPI_COUNT - 1) {
+        value = relayMicros;
+        return reached(MILESTONE_RELAY);
+    }
+    Milestone milestone = (Milestone)(index + 1);
+    if (!reached(MILESTONE_ABOVE_THRESHOLD) || !reached(milestone)) return false;
+    value = stamps[milestone] - stamps[MILESTONE_ABOVE_THRESHOLD];
+    return true;
+}
+
+void IncidentTimeline::updateStats() {
+    IncidentStatsHeader header;
+    EEPROM.get(INCIDENT_EEPROM_ADDRESS, header);
+    if (header.magic != INCIDENT_MAGIC) clearStats();
+    EEPROM.get(INCIDENT_EEPROM_ADDRESS, header);
+    header.incidents++;
+    EEPROM.put(INCIDENT_EEPROM_ADDRESS, header);
+    for (uint8_t i = 0; i < INCIDENT_KPI_COUNT; i++) {
+        unsigned long value;
+        if (!kpi(i, value)) continue;
+        KpiStats stats;
+        EEPROM.get(statsAddress(i), stats);
+        if (stats.count == 0 || value < stats.minimum) stats.minimum = value;
+        if (stats.count == 0 || value > stats.maximum) stats.maximum = value;
+        if (stats.count < 0xFFFF) stats.count++;
+        if (value >= stats.mean) stats.mean += (value - stats.mean) / stats.count;
+        else stats.mean -= (stats.mean - value) / stats.count;
+        EEPROM.put(statsAddress(i), stats);
+    }
+}
+
+void IncidentTimeline::clearStats() {
+    IncidentStatsHeader header = { INCIDENT_MAGIC, 0 };
+    KpiStats stats = { 0, 0, 0, 0 };
+    EEPROM.put(INCIDENT_EEPROM_ADDRESS, header);
+    for (uint8_t i = 0; i < INCIDENT_KPI_COUNT; i++) EEPROM.put(statsAddress(i), stats);
+}
+
+void IncidentTimeline::startPrint() {
+    printLine = 0;
+}
+
+static void printValue(Print& out, bool valid, unsigned long value) {
+    if (valid) out.print(value);
+    else out.print('-');
+}
+
+void IncidentTimeline::servicePrint() {
+    while (printLine >= 0 && logger.hasRoom()) {
+        if (!LOG_ENABLED(LOG_LEVEL_INFO) || printLine > INCIDENT_KPI_COUNT) {
+            printLine = -1;
+            return;
+        }
+        IncidentStatsHeader header;
+        EEPROM.get(INCIDENT_EEPROM_ADDRESS, header);
+        bool valid = header.magic == INCIDENT_MAGIC;
+        if (printLine == 0) {
+            LOG_INFO(F("Incident KPIs in us: last / min / mean / max ("), valid ? header.incidents : 0, F(")"));
+        } else {
+            uint8_t index = printLine - 1;
+            KpiStats stats;
+            EEPROM.get(statsAddress(index), stats);
+            valid = valid && stats.count > 0;
+            unsigned long value;
+            bool reachedKpi = kpi(index, value);
+            LogLine out;
+            switch (index) {
+                case 0: out.print(F("detect ")); break;
+                case 1: out.print(F("track ")); break;
+                case 2: out.print(F("aim ")); break;
+                case 3: out.print(F("relay ")); break;
+                case 4: out.print(F("last ")); break;
+                default: out.print(F("water ")); break;
+            }
+            printValue(out, reachedKpi, value);
+            out.print(F(" / "));
+            printValue(out, valid, stats.minimum);
+            out.print(F(" / "));
+            printValue(out, valid, stats.mean);
+            out.print(F(" / "));
+            printValue(out, valid, stats.maximum);
+            logger.commit(out);
+        }
+        printLine++;
+    }
+}
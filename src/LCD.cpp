@@ -1,7 +1,10 @@
 #include "LCD.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_DISPLAY
 
 // Create LCD object
-LiquidCrystal_I2C lcd(LCD_I2C_ADDR, LCD_COLS, LCD_ROWS);
+I2cLcd lcd(LCD_I2C_ADDR);
 
 // Create DHT sensor object
 DHT dht(DHTPIN, DHTTYPE);
@@ -41,8 +44,7 @@ int displayState = 0; // 0: normal, 1: warning, 2: comparison
  * Initialize the LCD and buffering system 
  */
 void initializeLCD() {
-  // Initialize LCD hardware
-  Wire.begin();
+  // Initialize LCD hardware (also starts the I2C transmit queue)
   lcd.init();
   lcd.backlight();
   
@@ -76,8 +78,9 @@ void initializeDHT() {
 
 /**
  * Update temperature and humidity readings from DHT sensor
+ * Returns true when a new valid reading was taken
  */
-void updateDHTReadings() {
+bool updateDHTReadings() {
   unsigned long currentTime = millis();
   if (currentTime - lastDHTRead >= DHT_READ_INTERVAL) {
     lastDHTRead = currentTime;
@@ -90,13 +93,12 @@ void updateDHTReadings() {
     if (!isnan(newHumidity) && !isnan(newTemperature)) {
       humidity = newHumidity;
       temperature = newTemperature;
-      Serial.print(F("DHT Update - Temp: "));
-      Serial.print(temperature);
-      Serial.print(F("°C, Humidity: "));
-      Serial.print(humidity);
-      Serial.println(F("%"));
+      LOG_DEBUG(F("DHT Update - Temp: "), logFloat(temperature, 2), F("°C, Humidity: "),
+                logFloat(humidity, 2), F("%"));
+      return true;
     }
   }
+  return false;
 }
 
 /**
@@ -166,8 +168,10 @@ void updateLCDDisplay() {
   if ((lcdState.needsUpdate || lcdState.forceUpdate) && 
       (lcdState.forceUpdate || currentTime - lcdState.lastUpdateTime >= lcdState.updateInterval)) {
     
-    // Update LCD with buffered content
-    bool anyChanges = false;
+    // Update LCD with buffered content. Each changed row is queued as one
+    // I2C frame and sent in the background; a row that does not fit in
+    // the queue stays pending for the next call (back-pressure).
+    bool pending = false;
     
     for (int row = 0; row < LCD_ROWS; row++) {
       // Check if this row has changed
@@ -181,24 +185,24 @@ void updateLCDDisplay() {
       
       // If row changed, update the entire row
       if (rowChanged) {
-        anyChanges = true;
-        lcd.setCursor(0, row);
-        for (int col = 0; col < LCD_COLS; col++) {
-          lcdState.display[row][col] = lcdState.buffer[row][col];
-          lcd.write(lcdState.display[row][col]);
+        if (lcd.writeRow(row, lcdState.buffer[row], LCD_COLS)) {
+          memcpy(lcdState.display[row], lcdState.buffer[row], LCD_COLS);
+        } else {
+          pending = true;
         }
       }
     }
     
     // Update state
     lcdState.lastUpdateTime = currentTime;
-    lcdState.needsUpdate = false;
-    lcdState.forceUpdate = false;
+    lcdState.needsUpdate = pending;
+    lcdState.forceUpdate = pending && lcdState.forceUpdate;
   }
 }
 
 /**
- * Display the startup message
+ * Display the startup message (returns immediately; LCDManager keeps it
+ * on screen for STARTUP_SPLASH_TIME)
  */
 void showStartupMessage() {
   clearLCDBuffer();
@@ -206,7 +210,17 @@ void showStartupMessage() {
   bufferPrint(1, 0, " Initializing... ");
   lcdState.forceUpdate = true;
   updateLCDDisplay();
-  delay(2000);
+}
+
+/**
+ * Switch the LCD backlight on or off (used by the idle sentinel mode)
+ */
+void setLCDBacklight(bool on) {
+  if (on) {
+    lcd.backlight();
+  } else {
+    lcd.noBacklight();
+  }
 }
 
 /**
@@ -245,8 +259,7 @@ void updateLCD(bool flameDetected, float angle) {
  * Update LCD with temperature and humidity information when no fire detected
  */
 void updateLCDWithTempHumidity(bool flameDetected, float angle) {
-  // Update DHT sensor readings first
-  updateDHTReadings();
+  // ClimateFusion takes the DHT readings shown here
   
   // If there's a fire, use the standard display
   if (flameDetected) {
@@ -409,6 +422,18 @@ void updateLCDWithCalibrationStatus(bool flameDetected, float angle, bool calibr
   }
 }
 
+/**
+ * Display a sensor fault and the sensors still in use ("Using: R - M")
+ */
+void displaySensorFault(uint8_t channelMask) {
+  clearLCDBuffer();
+  bufferPrint(0, 0, "SENSOR FAULT");
+  bufferPrint(1, 0, "Using:");
+  bufferWrite(1, 7, (channelMask & 0x01) ? 'R' : '-');
+  bufferWrite(1, 9, (channelMask & 0x02) ? 'L' : '-');
+  bufferWrite(1, 11, (channelMask & 0x04) ? 'M' : '-');
+}
+
 /**
  * Clear the LCD display
  */
@@ -1,7 +1,26 @@
 #include "../include/LCDManager.h"
 
-LCDManager::LCDManager(unsigned long interval)
-    : refreshInterval(interval), lastLCDUpdate(0), lastFlameState(false), lastAngle(0), dhtInitialized(false) {}
+LCDManager::LCDManager(const DisplaySettings& settings)
+    :
+#ifndef FIXED_SETTINGS
+      config(settings),
+#endif
+      lastLCDUpdate(0), contentChanged(false), dhtInitialized(false),
+      splashEnd(0) {}
+
+void LCDManager::begin() {
+    // initializeLCD() has put up the startup message
+    splashEnd = millis() + STARTUP_SPLASH_TIME;
+    // Flame edges and significant angle changes force an immediate refresh
+    eventBus.subscribe(EVENT_MASK(EVENT_FLAME_START) | EVENT_MASK(EVENT_FLAME_END) |
+                       EVENT_MASK(EVENT_ANGLE_CHANGED) | EVENT_MASK(EVENT_CALIBRATION_NEEDED) |
+                       EVENT_MASK(EVENT_SENSOR_FAULT) | EVENT_MASK(EVENT_SENSOR_RECOVERED),
+                       handleEvent, this);
+}
+
+void LCDManager::handleEvent(const Event& event, void* context) {
+    static_cast<LCDManager*>(context)->contentChanged = true;
+}
 
 void LCDManager::update(bool flameDetected, float angle, FlameTriangulation& flameSensor) {
     // Initialize DHT sensor on first call
@@ -11,6 +30,11 @@ void LCDManager::update(bool flameDetected, float angle, FlameTriangulation& fla
     }
 
     unsigned long now = millis();
+    if (splashEnd) {
+        if (!flameDetected && (long)(now - splashEnd) < 0) return;
+        splashEnd = 0;
+        contentChanged = true;
+    }
     if (flameSensor.calibrationNeeded) {
         updateLCDWithCalibrationStatus(
             flameDetected, angle, true,
@@ -18,23 +42,23 @@ void LCDManager::update(bool flameDetected, float angle, FlameTriangulation& fla
             flameSensor.getCurrentAmbient1(), flameSensor.getCurrentAmbient2(), flameSensor.getCurrentAmbient3()
         );
         lastLCDUpdate = now;
-        lastFlameState = flameDetected;
-        lastAngle = angle;
+        contentChanged = false;
         return;
     }
-    if (now - lastLCDUpdate >= refreshInterval ||
-        flameDetected != lastFlameState ||
-        (flameDetected && abs(angle - lastAngle) > 3.0)) {
+    if (contentChanged || now - lastLCDUpdate >= config.refreshInterval) {
         
-        // Use temperature/humidity display when no flame detected
-        if (!flameDetected) {
+        // A degraded sensor head alternates with the normal idle display
+        if (!flameDetected && flameSensor.getChannelMask() != ALL_SENSORS_MASK &&
+            (now / SENSOR_FAULT_DISPLAY_TIME) % 2 == 0) {
+            displaySensorFault(flameSensor.getChannelMask());
+        } else if (!flameDetected) {
+            // Use temperature/humidity display when no flame detected
             updateLCDWithTempHumidity(flameDetected, angle);
         } else {
             updateLCD(flameDetected, angle);
         }
         
         lastLCDUpdate = now;
-        lastFlameState = flameDetected;
-        lastAngle = angle;
+        contentChanged = false;
     }
 }
@@ -0,0 +1,25 @@
+#include "../include/Log.h"
+
+Logger logger;
+
+size_t LogLine::write(uint8_t c) {
+    // Room is kept for the line end
+    if (length >= LOG_LINE_SIZE - 2) return 0;
+    text[length++] = c;
+    return 1;
+}
+
+void Logger::commit(LogLine& out) {
+    out.text[out.length++] = '\r';
+    out.text[out.length++] = '\n';
+    // In blocking mode Serial.write waits for the UART to drain
+    if (!blocking && Serial.availableForWrite() < out.length) {
+        if (dropped < 0xFFFF) dropped++;
+        return;
+    }
+    Serial.write((const uint8_t*)out.text, out.length);
+}
+
+bool Logger::hasRoom() const {
+    return Serial.availableForWrite() >= LOG_LINE_SIZE;
+}
@@ -0,0 +1,106 @@
+#include "../include/PowerManager.h"
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <avr/interrupt.h>
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_POWER
+
+// Timer0 is halted while asleep, so millis() is advanced by hand on wake
+extern volatile unsigned long timer0_millis;
+
+// Approximate duration of one conversion at the default /128 prescaler
+#define ADC_CONVERSION_MICROS 104
+
+ISR(WDT_vect) {
+    // Wake-up only; the watchdog stays in interrupt mode
+}
+
+// ADC_vect is defined by AdcSampler and acts as a bare wake-up source
+// while the sampler is stopped
+
+PowerManager::PowerManager(unsigned long idleDelay)
+    : idleEntryDelay(idleDelay), lastFlameTime(0), sentinelActive(false),
+      awakeStart(0), awakeMicros(0), sleptMicros(0), lastReportTime(0) {}
+
+void PowerManager::update(bool flameDetected) {
+    if (flameDetected) lastFlameTime = millis();
+}
+
+bool PowerManager::isSentinelDue() const {
+    return !sentinelActive && millis() - lastFlameTime >= idleEntryDelay;
+}
+
+bool PowerManager::isSentinelActive() const { return sentinelActive; }
+
+void PowerManager::enterSentinel() {
+    LOG_INFO(F("Entering idle sentinel mode"));
+    Serial.flush(); // The UART stops while asleep
+    // Watchdog in interrupt-only mode provides the sample tick
+    cli();
+    wdt_reset();
+    MCUSR &= ~(1 << WDRF);
+    WDTCSR = (1 << WDCE) | (1 << WDE);
+    WDTCSR = (1 << WDIE) | (SENTINEL_WDT_TIMEOUT & 0x07) | ((SENTINEL_WDT_TIMEOUT & 0x08) ? (1 << WDP3) : 0);
+    sei();
+    sentinelActive = true;
+    awakeMicros = 0;
+    sleptMicros = 0;
+    lastReportTime = millis();
+    awakeStart = micros();
+}
+
+void PowerManager::exitSentinel() {
+    wdt_disable();
+    ADCSRA &= ~(1 << ADIE);
+    sentinelActive = false;
+    lastFlameTime = millis();
+    reportDutyCycle();
+    LOG_INFO(F("Leaving idle sentinel mode"));
+}
+
+void PowerManager::sleepUntilNextTick() {
+    awakeMicros += micros() - awakeStart;
+    Serial.flush();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    cli();
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    // Account for the time Timer0 did not count
+    cli();
+    timer0_millis += SENTINEL_TICK_MS;
+    sei();
+    sleptMicros += SENTINEL_TICK_MS * 1000UL;
+    awakeStart = micros();
+}
+
+int PowerManager::sampleChannel(uint8_t pin) {
+    // Select channel with AVcc reference, as analogRead() does (10-bit result)
+    ADMUX = (1 << REFS0) | ((pin - A0) & 0x07);
+    ADCSRA |= (1 << ADIE);
+    // Entering ADC noise reduction sleep starts the conversion; its
+    // completion interrupt wakes the CPU
+    set_sleep_mode(SLEEP_MODE_ADC);
+    sleep_enable();
+    do {
+        sei();
+        sleep_cpu();
+    } while (ADCSRA & (1 << ADSC));
+    sleep_disable();
+    ADCSRA &= ~(1 << ADIE);
+    sleptMicros += ADC_CONVERSION_MICROS;
+    return ADC;
+}
+
+void PowerManager::reportDutyCycle() {
+    unsigned long now = millis();
+    if (sentinelActive && now - lastReportTime < SENTINEL_REPORT_INTERVAL) return;
+    lastReportTime = now;
+    unsigned long total = awakeMicros + sleptMicros;
+    LOG_INFO(F("Sentinel awake/asleep us: "), awakeMicros, '/', sleptMicros,
+             F(" ("), logFloat(total ? (float)awakeMicros * 100.0 / total : 0.0, 2), F("%)"));
+    awakeMicros = 0;
+    sleptMicros = 0;
+}
@@ -1,37 +1,230 @@
 #include "../include/PumpControl.h"
+#include "../include/EventBus.h"
+#include "../include/IncidentTimeline.h"
+#include "../include/Log.h"
 
-PumpControl::PumpControl(int relay, float threshold, unsigned long pulseDur, unsigned long pulseDel)
-    : relayPin(relay), angleThreshold(threshold), pulseDuration(pulseDur), pulseDelay(pulseDel), pumpEnabled(false), pumpActive(false), pumpStateChangeTime(0) {}
+#define LOG_MODULE LOG_PUMP
+
+PumpControl::PumpControl(const PumpSettings& settings)
+    :
+#ifndef FIXED_SETTINGS
+      config(settings),
+#endif
+      pumpEnabled(false), pumpActive(false), pumpStateChangeTime(0),
+      serviceBearing(-1), dwellStart(0), lastTargetFlameTime(0), lastSurveyTime(0), surveyedThisIncident(false), surveyRequested(false),
+      currentPulse(0), pulseGain(1.0), prePulseIntensity(0), targetPeakIntensity(0), lowIntensitySince(0), ineffectivePulses(0), extinguished(false),
+      outBearing(-1), outPeakIntensity(0), budget((long)PUMP_BURST_BUDGET * 100), lastBudgetUpdate(0),
+      incidentActive(false), incidentStart(0), lastLiveFlameTime(0), incidentWater(0), incidentPulses(0), timeline(nullptr) {}
 
 void PumpControl::begin() {
-    pinMode(relayPin, OUTPUT);
-    digitalWrite(relayPin, HIGH); // Ensure pump is off (active low)
+    RelayPin::high(); // Ensure pump is off (active low) before driving the pin
+    RelayPin::output();
     pumpEnabled = false;
     pumpActive = false;
     pumpStateChangeTime = millis();
+    lastBudgetUpdate = pumpStateChangeTime;
 }
 
-void PumpControl::update(bool flameDetected, int servoAngle, int targetServoAngle) {
-    bool shouldEnable = false;
-    if (flameDetected) {
-        int angleDifference = abs(servoAngle - targetServoAngle);
-        shouldEnable = (angleDifference <= angleThreshold);
+// Pulses are sized from the flame's intensity and the detection confidence,
+// and each one is judged by how far the intensity has fallen once the
+// settle time (config.pulseDelay) is over. The target is declared out when its
+// intensity stays low relative to its peak, before detection drops.
+void PumpControl::update(bool flameDetected, int servoAngle, int targetServoAngle, float intensity, float confidence) {
+    unsigned long now = millis();
+    updateBudget(now);
+    bool aimed = abs(servoAngle - targetServoAngle) <= config.angleThreshold;
+    trackExtinguish(flameDetected, aimed, intensity, now);
+    updateIncident(flameDetected && !extinguished, now);
+
+    pumpEnabled = flameDetected && aimed && !extinguished;
+    if (pumpEnabled && timeline) timeline->mark(MILESTONE_ON_TARGET);
+    if (pumpActive) {
+        // End the pulse at its length, or early when aim or budget is lost
+        if (!pumpEnabled || budget <= 0 || now - pumpStateChangeTime >= currentPulse) {
+            setRelay(false, now);
+        }
+    } else if (pumpEnabled && now - pumpStateChangeTime >= config.pulseDelay) {
+        if (prePulseIntensity > 0) {
+            // Judge the previous pulse now that the intensity has settled
+            float remaining = intensity / prePulseIntensity;
+            if (remaining > PULSE_EFFECTIVE_RATIO) {
+                // A weak signal that no longer responds to water is embers
+                // or a hot surface rather than a flame
+                if (intensity < targetPeakIntensity * REIGNITE_RATIO && ++ineffectivePulses >= EMBER_PULSE_COUNT) {
+                    declareExtinguished(now);
+                    return;
+                }
+                pulseGain = min(pulseGain * 1.25f, 2.0f);
+            } else {
+                ineffectivePulses = 0;
+                if (remaining < PULSE_OVERKILL_RATIO) pulseGain = max(pulseGain * 0.9f, 0.5f);
+            }
+        }
+        currentPulse = pulseLength(intensity, confidence);
+        if (budget >= (long)currentPulse * 100) {
+            prePulseIntensity = intensity;
+            setRelay(true, now);
+        }
     }
-    pumpEnabled = shouldEnable;
-    if (pumpEnabled) {
-        unsigned long now = millis();
-        if (now - pumpStateChangeTime >= (pumpActive ? pulseDuration : pulseDelay)) {
-            pumpActive = !pumpActive;
-            digitalWrite(relayPin, pumpActive ? LOW : HIGH);
-            pumpStateChangeTime = now;
+}
+
+unsigned long PumpControl::pulseLength(float intensity, float confidence) const {
+    // Intensity and confidence scale the pulse between half and full length;
+    // a small reading can also be a large flame further away
+    float drive = 0.5 + 0.5 * constrain(intensity / PUMP_FULL_INTENSITY, 0.0, 1.0) * constrain(confidence, 0.0, 1.0);
+    float length = config.pulseDuration * pulseGain * drive;
+    return constrain((unsigned long)length, (unsigned long)PUMP_MIN_PULSE, config.pulseDuration * 2);
+}
+
+void PumpControl::setRelay(bool active, unsigned long now) {
+    if (pumpActive) incidentWater += now - pumpStateChangeTime;
+    if (active) incidentPulses++;
+    pumpActive = active;
+    RelayPin::write(!pumpActive);
+    pumpStateChangeTime = now;
+    if (timeline) timeline->relay(pumpActive);
+    eventBus.publish(EVENT_PUMP_STATE, pumpActive ? 1 : 0);
+}
+
+void PumpControl::updateBudget(unsigned long now) {
+    // Token bucket in hundredths of a ms: refills at the duty limit and
+    // drains at full rate while the relay is on
+    long elapsed = now - lastBudgetUpdate;
+    lastBudgetUpdate = now;
+    budget += elapsed * PUMP_DUTY_PERCENT;
+    if (pumpActive) budget -= elapsed * 100;
+    if (budget > (long)PUMP_BURST_BUDGET * 100) budget = (long)PUMP_BURST_BUDGET * 100;
+}
+
+void PumpControl::trackExtinguish(bool flameDetected, bool aimed, float intensity, unsigned long now) {
+    if (extinguished) {
+        // Hysteresis: only a flame well above the level at which it was
+        // declared out re-arms the pump
+        if (flameDetected && intensity > outPeakIntensity * REIGNITE_RATIO) {
+            extinguished = false;
+            outBearing = -1;
+            resetTargetTracking();
         }
+        return;
+    }
+    // Intensity only means something while the head is on a detected flame;
+    // a flame that drops out of detection altogether is handled by
+    // selectTarget (EXTINGUISH_CONFIRM_TIME) and the incident timeout
+    if (!aimed || !flameDetected) {
+        lowIntensitySince = 0;
+        return;
+    }
+    if (intensity > targetPeakIntensity) targetPeakIntensity = intensity;
+    if (intensity < targetPeakIntensity * EXTINGUISH_LOW_RATIO) {
+        if (lowIntensitySince == 0) lowIntensitySince = now;
+        if (now - lowIntensitySince >= EXTINGUISH_HOLD_TIME) declareExtinguished(now);
     } else {
-        if (pumpActive) {
-            pumpActive = false;
-            digitalWrite(relayPin, HIGH);
+        lowIntensitySince = 0;
+    }
+}
+
+void PumpControl::declareExtinguished(unsigned long now) {
+    extinguished = true;
+    outBearing = serviceBearing;
+    outPeakIntensity = targetPeakIntensity;
+    if (pumpActive) setRelay(false, now);
+}
+
+void PumpControl::updateIncident(bool liveFlame, unsigned long now) {
+    if (liveFlame) {
+        if (!incidentActive) {
+            incidentActive = true;
+            incidentStart = now;
+            incidentWater = 0;
+            incidentPulses = 0;
         }
+        lastLiveFlameTime = now;
+    } else if (incidentActive && !pumpActive && now - lastLiveFlameTime >= INCIDENT_END_TIME) {
+        incidentActive = false;
+        LOG_INFO(F("Incident over: water "), incidentWater, F(" ms in "), incidentPulses,
+                 F(" pulses over "), (lastLiveFlameTime - incidentStart) / 1000, F(" s"));
+        if (timeline) timeline->close();
+        // The next incident starts from a clean slate
+        extinguished = false;
+        outBearing = -1;
+        resetTargetTracking();
     }
 }
 
+void PumpControl::resetTargetTracking() {
+    pulseGain = 1.0;
+    targetPeakIntensity = 0;
+    prePulseIntensity = 0;
+    lowIntensitySince = 0;
+    ineffectivePulses = 0;
+}
+
+// Chooses the target to spray: the strongest flame that has not had its
+// turn, for at most config.dwellLimit ms before moving on to the next one.
+// Returns its servo bearing, or -1 when there is nothing to service.
+int PumpControl::selectTarget(FlameTargetList& targets, int servoAngle, bool flameDetected, bool surveying) {
+    unsigned long now = millis();
+    targets.expire(TARGET_TIMEOUT);
+    if (targets.count() == 0) {
+        serviceBearing = -1;
+        surveyedThisIncident = false;
+        return -1;
+    }
+    if (surveying) return -1;
+
+    int index = serviceBearing >= 0 ? targets.find(serviceBearing) : -1;
+    if (index < 0) {
+        serviceBearing = -1;
+    } else {
+        serviceBearing = targets.get(index).bearing; // Follow bearing refinements
+        bool onTarget = abs(servoAngle - serviceBearing) <= TARGET_MERGE_DEGREES;
+        if (onTarget && flameDetected) lastTargetFlameTime = now;
+        if (extinguished || (onTarget && now - lastTargetFlameTime >= EXTINGUISH_CONFIRM_TIME)) {
+            // Declared out, or nothing seen at the bearing any more
+            targets.remove(index);
+            serviceBearing = -1;
+        } else if (now - dwellStart >= config.dwellLimit) {
+            targets.markServiced(index);
+            serviceBearing = -1;
+            // With a single known flame, sweep once for others before the next turn
+            if (targets.count() == 1 &&
+                (!surveyedThisIncident || now - lastSurveyTime >= SURVEY_INTERVAL)) {
+                surveyRequested = true;
+                surveyedThisIncident = true;
+                lastSurveyTime = now;
+                return -1;
+            }
+        }
+    }
+
+    if (serviceBearing < 0) {
+        // Embers left where a flame was declared out are not targets until
+        // they grow back past the re-ignite level
+        for (int i = targets.count() - 1; outBearing >= 0 && i >= 0; i--) {
+            if (abs(targets.get(i).bearing - outBearing) <= TARGET_MERGE_DEGREES &&
+                targets.get(i).strength < outPeakIntensity * REIGNITE_RATIO) {
+                targets.remove(i);
+            }
+        }
+        index = targets.highestPriority();
+        if (index >= 0) {
+            serviceBearing = targets.get(index).bearing;
+            dwellStart = now;
+            lastTargetFlameTime = now;
+            extinguished = false;
+            resetTargetTracking();
+        }
+    }
+    return serviceBearing;
+}
+
+bool PumpControl::takeSurveyRequest() {
+    bool requested = surveyRequested;
+    surveyRequested = false;
+    return requested;
+}
+
 bool PumpControl::isPumpActive() const { return pumpActive; }
 bool PumpControl::isPumpEnabled() const { return pumpEnabled; }
+bool PumpControl::isExtinguished() const { return extinguished; }
+unsigned long PumpControl::getIncidentWaterTime() const { return incidentWater; }
@@ -0,0 +1,180 @@
+#include "../include/RawCapture.h"
+
+#define CAPTURE_INDEX_MASK (CAPTURE_BUFFER_SIZE - 1)
+#define CAPTURE_GAP_FLAG 0x80000000UL
+
+#if (CAPTURE_BUFFER_SIZE & CAPTURE_INDEX_MASK) != 0
+#error "CAPTURE_BUFFER_SIZE must be a power of two"
+#endif
+
+RawCapture rawCapture;
+
+// LSB-first bit packer that writes whole bytes as they fill and keeps a
+// running CRC-8 of everything it writes
+struct BitWriter {
+    Print& out;
+    uint32_t bits;
+    uint8_t count;
+    uint8_t crc;
+
+    BitWriter(Print& out) : out(out), bits(0), count(0), crc(0) {}
+
+    void byte(uint8_t value) {
+        out.write(value);
+        crc ^= value;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    // width <= 11 (a 10-bit delta), so the accumulator never exceeds 18 bits
+    void put(uint16_t value, uint8_t width) {
+        bits |= (uint32_t)(value & ((1U << width) - 1)) << count;
+        count += width;
+        while (count >= 8) {
+            byte((uint8_t)bits);
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void pad() {
+        if (count > 0) byte((uint8_t)bits);
+        bits = 0;
+        count = 0;
+    }
+};
+
+static inline void unpackSample(uint32_t sample, int16_t* readings) {
+    readings[0] = sample & 0x3FF;
+    readings[1] = (sample >> 10) & 0x3FF;
+    readings[2] = (sample >> 20) & 0x3FF;
+}
+
+RawCapture::RawCapture()
+    : head(0), tail(0), pendingLost(0), lostCount(0), active(false), nextIndex(0) {}
+
+void RawCapture::start() {
+    uint8_t oldSREG = SREG;
+    cli();
+    head = 0;
+    tail = 0;
+    pendingLost = 0;
+    lostCount = 0;
+    nextIndex = 0;
+    active = true;
+    SREG = oldSREG;
+}
+
+void RawCapture::stop() { active = false; }
+
+bool RawCapture::isActive() const { return active; }
+
+uint16_t RawCapture::getLostCount() const {
+    uint8_t oldSREG = SREG;
+    cli();
+    uint16_t lost = lostCount;
+    SREG = oldSREG;
+    return lost;
+}
+
+void RawCapture::push(uint16_t reading1, uint16_t reading2, uint16_t reading3) {
+    if (!active) return;
+    uint8_t free = CAPTURE_INDEX_MASK - ((head - tail) & CAPTURE_INDEX_MASK);
+    if (pendingLost) {
+        // The marker and the sample after it must go in together
+        if (free < 2) {
+            if (pendingLost < 0xFFFF) pendingLost++;
+            lostCount++;
+            return;
+        }
+        ring[head] = CAPTURE_GAP_FLAG | pendingLost;
+        head = (head + 1) & CAPTURE_INDEX_MASK;
+        pendingLost = 0;
+    } else if (free == 0) {
+        pendingLost = 1;
+        lostCount++;
+        return;
+    }
+    ring[head] = (uint32_t)reading1 | ((uint32_t)reading2 << 10) | ((uint32_t)reading3 << 20);
+    head = (head + 1) & CAPTURE_INDEX_MASK;
+}
+
+uint8_t RawCapture::flush(Print& out) {
+    uint8_t frames = 0;
+    for (;;) {
+        // Entries between tail and head are never touched by the interrupt
+        uint8_t end = head;
+        if (tail == end) break;
+        uint32_t first = ring[tail];
+        if (first & CAPTURE_GAP_FLAG) {
+            nextIndex += (uint16_t)first;
+            tail = (tail + 1) & CAPTURE_INDEX_MASK;
+            continue;
+        }
+        uint8_t count = 0;
+        bool gap = false;
+        for (uint8_t i = tail; count < CAPTURE_FRAME_SAMPLES && i != end;
+             i = (i + 1) & CAPTURE_INDEX_MASK) {
+            if (ring[i] & CAPTURE_GAP_FLAG) {
+                gap = true;
+                break;
+            }
+            count++;
+        }
+        // Wait for a full frame unless a gap ends this one early
+        if (count < CAPTURE_FRAME_SAMPLES && !gap) break;
+        writeFrame(out, count);
+        frames++;
+    }
+    return frames;
+}
+
+void RawCapture::writeFrame(Print& out, uint8_t count) {
+    int16_t previous[3], current[3];
+
+    // Smallest two's complement width that holds every delta in the frame
+    uint16_t magnitude = 0;
+    bool changed = false;
+    unpackSample(ring[tail], previous);
+    for (uint8_t n = 1; n < count; n++) {
+        unpackSample(ring[(tail + n) & CAPTURE_INDEX_MASK], current);
+        for (uint8_t c = 0; c < 3; c++) {
+            int16_t delta = current[c] - previous[c];
+            if (delta != 0) changed = true;
+            magnitude |= delta >= 0 ? delta : ~delta;
+            previous[c] = current[c];
+        }
+    }
+    uint8_t width = 0;
+    if (changed) {
+        width = 1;
+        while (magnitude) {
+            width++;
+            magnitude >>= 1;
+        }
+    }
+
+    out.write((uint8_t)CAPTURE_SYNC1);
+    out.write((uint8_t)CAPTURE_SYNC2);
+    BitWriter writer(out);
+    writer.byte((uint8_t)nextIndex);
+    writer.byte((uint8_t)(nextIndex >> 8));
+    writer.byte(count);
+    writer.byte(width);
+
+    unpackSample(ring[tail], previous);
+    for (uint8_t c = 0; c < 3; c++) writer.put(previous[c], 10);
+    for (uint8_t n = 1; n < count; n++) {
+        unpackSample(ring[(tail + n) & CAPTURE_INDEX_MASK], current);
+        for (uint8_t c = 0; c < 3; c++) {
+            if (width) writer.put((uint16_t)(current[c] - previous[c]), width);
+            previous[c] = current[c];
+        }
+    }
+    writer.pad();
+    out.write(writer.crc);
+
+    tail = (tail + count) & CAPTURE_INDEX_MASK;
+    nextIndex += count;
+}
@@ -0,0 +1,23 @@
+#include "../include/SampleAligner.h"
+
+void SampleAligner::align(const SampleTriple& triple, int& reading1, int& reading2, int& reading3) {
+    // The stamps wrap every 65 ms; differences are taken modulo 2^16
+    uint8_t earliest = 0;
+    for (uint8_t ch = 1; ch < ADC_SAMPLER_CHANNELS; ch++) {
+        if ((int16_t)(triple.stamp[ch] - triple.stamp[earliest]) < 0) earliest = ch;
+    }
+    int aligned[ADC_SAMPLER_CHANNELS];
+    for (uint8_t ch = 0; ch < ADC_SAMPLER_CHANNELS; ch++) {
+        aligned[ch] = triple.reading[ch];
+        uint16_t lag = triple.stamp[ch] - triple.stamp[earliest];
+        uint16_t span = triple.stamp[ch] - triple.previousStamp[ch];
+        if (triple.hasPrevious && lag > 0 && span > lag) {
+            // Rounded to the nearest count
+            long change = (long)(triple.reading[ch] - triple.previous[ch]) * lag;
+            aligned[ch] -= (change + (change >= 0 ? span / 2 : -(long)(span / 2))) / span;
+        }
+    }
+    reading1 = aligned[0];
+    reading2 = aligned[1];
+    reading3 = aligned[2];
+}
@@ -0,0 +1,188 @@
+#include "../include/SensorHealth.h"
+#include "../include/EventBus.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_HEALTH
+
+SensorHealth::SensorHealth() {
+    reset();
+}
+
+void SensorHealth::reset() {
+    allFaulty = false;
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        channels[c].lastReading = -1;
+        channels[c].flatFrames = 0;
+        channels[c].responseRatio = 256;
+        channels[c].faults = 0;
+        channels[c].symptomatic = false;
+        channels[c].since = 0;
+    }
+}
+
+static int medianOfThree(int a, int b, int c) {
+    if (a > b) { int t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+void SensorHealth::update(FlameTriangulation& flameSensor) {
+    unsigned long now = millis();
+    updateResponse(flameSensor);
+    int median = medianOfThree(flameSensor.getCurrentAmbient(0), flameSensor.getCurrentAmbient(1),
+                               flameSensor.getCurrentAmbient(2));
+    uint8_t mask = 0;
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        updateFaults(c, checkSymptoms(flameSensor, c, median), now);
+        if (channels[c].faults == 0) mask |= 1 << c;
+    }
+    // With every channel out of use nothing could ever be detected; an
+    // unreliable estimate is better than a blind one
+    if (mask == 0) {
+        mask = ALL_SENSORS_MASK;
+        if (!allFaulty) LOG_WARN(F("SENSOR FAULT: all channels, using all three"));
+    }
+    allFaulty = mask == ALL_SENSORS_MASK && isDegraded();
+    if (mask != flameSensor.getChannelMask()) flameSensor.setChannelMask(mask);
+}
+
+uint8_t SensorHealth::checkSymptoms(FlameTriangulation& flameSensor, uint8_t channel, int median) {
+    ChannelHealth& health = channels[channel];
+    int reading = flameSensor.getRawReading(channel);
+    uint8_t symptoms = 0;
+
+    // A live sensor always shows some noise, more so when oversampled. A
+    // flame strong enough to pin it at the rail silences it too, so only a
+    // channel that sees nothing counts.
+    bool detecting = flameSensor.isChannelDetecting(channel);
+    if (detecting || reading <= HEALTH_RAIL_MARGIN) {
+        health.flatFrames = 0;
+    } else if (reading == health.lastReading) {
+        if (health.flatFrames < HEALTH_FLAT_FRAMES) health.flatFrames++;
+    } else {
+        health.flatFrames = 0;
+    }
+    health.lastReading = reading;
+    if (health.flatFrames >= HEALTH_FLAT_FRAMES) symptoms |= SENSOR_FAULT_FLAT;
+
+    // A real flame strong enough to saturate one sensor shows up on the
+    // others too. Only channels still in use count as witnesses.
+    bool othersDetect = false;
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        if (c != channel && (flameSensor.getChannelMask() & (1 << c)) && flameSensor.isChannelDetecting(c)) {
+            othersDetect = true;
+        }
+    }
+    if (reading <= HEALTH_RAIL_MARGIN && !othersDetect) symptoms |= SENSOR_FAULT_RAIL;
+
+    // Baselines are compared only while nothing is in view
+    if (!othersDetect && !detecting &&
+        abs(flameSensor.getCurrentAmbient(channel) - median) > HEALTH_FAMILY_LIMIT) {
+        symptoms |= SENSOR_FAULT_FAMILY;
+    }
+
+    if (health.responseRatio < (int)(HEALTH_RESPONSE_RATIO * 256)) symptoms |= SENSOR_FAULT_WEAK;
+    return symptoms;
+}
+
+// Sensors 5 cm apart see a centred flame almost equally; a channel that
+// keeps answering well below its neighbours has a dirty window or is
+// failing. The ratio only moves while such a flame is in view.
+void SensorHealth::updateResponse(FlameTriangulation& flameSensor) {
+    if (!flameSensor.isFlameDetected() || abs(flameSensor.getFlameAngle()) > HEALTH_CENTRE_ANGLE) return;
+    uint8_t mask = flameSensor.getChannelMask();
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        float neighbours = 0;
+        uint8_t count = 0;
+        for (uint8_t n = 0; n < SENSOR_COUNT; n++) {
+            if (n != c && (mask & (1 << n))) {
+                neighbours += flameSensor.getChannelIntensity(n);
+                count++;
+            }
+        }
+        if (count == 0 || neighbours < HEALTH_RESPONSE_MIN * count) continue;
+        float ratio = flameSensor.getChannelIntensity(c) * count / neighbours;
+        int sample = (int)(constrain(ratio, 0.0, 4.0) * 256);
+        channels[c].responseRatio += (sample - channels[c].responseRatio) / 16;
+    }
+}
+
+void SensorHealth::updateFaults(uint8_t channel, uint8_t symptoms, unsigned long now) {
+    ChannelHealth& health = channels[channel];
+    if ((symptoms != 0) != health.symptomatic) {
+        health.symptomatic = symptoms != 0;
+        health.since = now;
+    }
+
+    uint8_t faults = health.faults;
+    if (health.symptomatic && now - health.since >= HEALTH_CONFIRM_TIME) {
+        faults |= symptoms;
+    } else if (!health.symptomatic && now - health.since >= HEALTH_RECOVERY_TIME) {
+        faults = 0;
+    }
+    if (faults == health.faults) return;
+
+    LogLine out;
+    if (health.faults == 0) {
+        eventBus.publish(EVENT_SENSOR_FAULT, channel);
+        out.print(F("SENSOR FAULT: "));
+    } else if (faults == 0) {
+        eventBus.publish(EVENT_SENSOR_RECOVERED, channel);
+        out.print(F("Sensor recovered: "));
+    } else {
+        out.print(F("SENSOR FAULT (more): "));
+    }
+    health.faults = faults;
+    printChannel(out, channel);
+    if (faults) {
+        out.print(F(" - "));
+        printFaults(out, faults);
+    }
+    if (LOG_ENABLED(faults ? LOG_LEVEL_WARN : LOG_LEVEL_INFO)) logger.commit(out);
+}
+
+uint8_t SensorHealth::getFaults(uint8_t channel) const {
+    return channels[channel].faults;
+}
+
+bool SensorHealth::isDegraded() const {
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        if (channels[c].faults) return true;
+    }
+    return false;
+}
+
+void SensorHealth::printChannel(Print& out, uint8_t channel) {
+    switch (channel) {
+        case 0: out.print(F("right")); break;
+        case 1: out.print(F("left")); break;
+        default: out.print(F("middle")); break;
+    }
+}
+
+void SensorHealth::printFaults(Print& out, uint8_t faults) {
+    bool first = true;
+    if (faults & SENSOR_FAULT_RAIL) { out.print(F("at rail")); first = false; }
+    if (faults & SENSOR_FAULT_FLAT) { if (!first) out.print(F(", ")); out.print(F("no noise")); first = false; }
+    if (faults & SENSOR_FAULT_FAMILY) { if (!first) out.print(F(", ")); out.print(F("baseline out of family")); first = false; }
+    if (faults & SENSOR_FAULT_WEAK) { if (!first) out.print(F(", ")); out.print(F("weak response")); }
+}
+
+void SensorHealth::printStatus() const {
+    if (!LOG_ENABLED(LOG_LEVEL_WARN)) return;
+    // One line; with several faulty channels the fault lists are cut short
+    LogLine out;
+    out.print(F("Sensor health: "));
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+        if (c > 0) out.print(F(", "));
+        printChannel(out, c);
+        if (channels[c].faults) {
+            out.print(F(" FAULT ("));
+            printFaults(out, channels[c].faults);
+            out.print(F(")"));
+        } else {
+            out.print(F(" OK"));
+        }
+    }
+    logger.commit(out);
+}
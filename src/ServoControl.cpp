@@ -1,7 +1,14 @@
 #include "../include/ServoControl.h"
+#include "../include/FlameTargets.h"
+#include "../include/IncidentTimeline.h"
 
-ServoControl::ServoControl(int pin, int minA, int maxA, int step, int delayMs, float speed)
-    : servoPin(pin), minAngle(minA), maxAngle(maxA), scanStep(step), scanDelay(delayMs), trackingSpeed(speed), scanDirection(true), lastServoUpdate(0), currentAngle(90), targetAngle(90) {}
+ServoControl::ServoControl(int pin, int minA, int maxA, const ServoSettings& settings)
+    : servoPin(pin),
+#ifndef FIXED_SETTINGS
+      minAngle(minA), maxAngle(maxA), config(settings),
+#endif
+      currentAngle(90), targetAngle(90), scanDirection(true), lastServoUpdate(0), surveyLegs(0),
+      reacquireBearing(90), reacquireWindow(0), reacquireLegs(0), timeline(nullptr) {}
 
 void ServoControl::begin(int initialAngle) {
     servo.attach(servoPin);
@@ -11,35 +18,114 @@ void ServoControl::begin(int initialAngle) {
     lastServoUpdate = millis();
 }
 
-void ServoControl::update(bool flameDetected, float flameAngle) {
+void ServoControl::update(bool flameDetected, float flameAngle, int serviceBearing) {
     unsigned long now = millis();
-    if (!flameDetected && now - lastServoUpdate < (unsigned long)scanDelay) return;
+    // Track the flame in view unless we are heading for a different target.
+    // Close to the target's bearing only: further out a stronger neighbour
+    // can still be in view and would pull the estimate towards itself.
+    bool tracking = flameDetected && surveyLegs == 0 &&
+                    (serviceBearing < 0 || abs(currentAngle - serviceBearing) <= SERVICE_TRACK_WINDOW);
+    // Tracking is rate limited as well: the heading is corrected from the
+    // sensors' relative angle, which lags until the servo has moved
+    if (now - lastServoUpdate < (unsigned long)config.scanDelay) return;
     lastServoUpdate = now;
-    if (flameDetected) {
+    if (surveyLegs > 0) {
+        if (scanStepOnce(SURVEY_STEP, minAngle, maxAngle)) surveyLegs--;
+        targetAngle = currentAngle;
+    } else if (tracking) {
+        if (timeline) timeline->mark(MILESTONE_TRACKING);
         targetAngle = mapFlameAngleToServo(flameAngle);
-        currentAngle = lerpAngle(currentAngle, targetAngle, trackingSpeed);
-        servo.write(currentAngle);
+        if (serviceBearing >= 0) {
+            targetAngle = constrain(targetAngle, serviceBearing - SERVICE_TRACK_WINDOW,
+                                    serviceBearing + SERVICE_TRACK_WINDOW);
+        }
+        currentAngle = lerpAngle(currentAngle, targetAngle, config.trackingSpeed);
+    } else if (serviceBearing >= 0) {
+        // Slew to the bearing recorded for the target being serviced
+        if (timeline) timeline->mark(MILESTONE_TRACKING);
+        targetAngle = constrain(serviceBearing, minAngle, maxAngle);
+        currentAngle += constrain(targetAngle - currentAngle, -SLEW_STEP, SLEW_STEP);
+    } else if (reacquireLegs > 0 && abs(currentAngle - reacquireBearing) > reacquireWindow) {
+        // Slew into the search window first
+        currentAngle += constrain(reacquireBearing - currentAngle, -SLEW_STEP, SLEW_STEP);
+    } else if (reacquireLegs > 0) {
+        if (scanStepOnce(config.scanStep, reacquireBearing - reacquireWindow, reacquireBearing + reacquireWindow)) {
+            reacquireLegs--;
+        }
+    } else {
+        scanStepOnce(config.scanStep, minAngle, maxAngle);
+    }
+    servo.write(currentAngle);
+}
+
+void ServoControl::startSurvey() {
+    // Sweep to the end of the current direction and back across the full
+    // range so every flame passes through the sensors' view
+    surveyLegs = 2;
+}
+
+bool ServoControl::isSurveying() const { return surveyLegs > 0; }
+
+void ServoControl::reacquire(int bearing, int window, int legs) {
+    reacquireBearing = constrain(bearing, minAngle + window, maxAngle - window);
+    reacquireWindow = window;
+    reacquireLegs = legs;
+}
+
+void ServoControl::moveTo(int angle) {
+    currentAngle = constrain(angle, minAngle, maxAngle);
+    targetAngle = currentAngle;
+    servo.write(currentAngle);
+    lastServoUpdate = millis();
+}
+
+// One scan step between low and high; true when it turned at an end
+bool ServoControl::scanStepOnce(int step, int low, int high) {
+    if (scanDirection) {
+        currentAngle += step;
+        if (currentAngle >= high) {
+            currentAngle = high;
+            scanDirection = false;
+            return true;
+        }
     } else {
-        if (scanDirection) {
-            currentAngle += scanStep;
-            if (currentAngle >= maxAngle) { currentAngle = maxAngle; scanDirection = false; }
-        } else {
-            currentAngle -= scanStep;
-            if (currentAngle <= minAngle) { currentAngle = minAngle; scanDirection = true; }
+        currentAngle -= step;
+        if (currentAngle <= low) {
+            currentAngle = low;
+            scanDirection = true;
+            return true;
         }
-        servo.write(currentAngle);
     }
+    return false;
+}
+
+void ServoControl::suspend() {
+    // Stop the control pulses; the servo holds its last position unpowered
+    servo.detach();
+}
+
+void ServoControl::resume() {
+    servo.attach(servoPin);
+    servo.write(currentAngle);
+    lastServoUpdate = millis();
 }
 
 int ServoControl::getCurrentAngle() const { return currentAngle; }
 int ServoControl::getTargetAngle() const { return targetAngle; }
 
 int ServoControl::mapFlameAngleToServo(float flameAngle) {
-    return map(constrain(flameAngle, -30, 30), -30, 30, maxAngle, minAngle);
+    // The sensors turn with the head, so the flame angle is relative to the
+    // current heading; a flame to the right (positive) means a lower angle
+    return constrain(currentAngle - (int)round(constrain(flameAngle, -30, 30)), minAngle, maxAngle);
 }
 
 int ServoControl::lerpAngle(int current, int target, float factor) {
-    factor = constrain(factor, 0.0, 1.0);
-    float result = current + factor * (target - current);
-    return round(result);
+    // Fixed-point step (factor in Q8); the float conversion folds away
+    // when the factor is a compile-time constant
+    int weight = (int)(constrain(factor, 0.0, 1.0) * 256 + 0.5);
+    int result = current + (int)(((long)(target - current) * weight + 128) >> 8);
+    // Always make progress: with relative tracking the target moves with the
+    // head, so a rounded-away step would stall a few degrees off the flame
+    if (result == current && target != current) result += target > current ? 1 : -1;
+    return result;
 }
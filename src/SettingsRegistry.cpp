@@ -0,0 +1,154 @@
+#include "../include/SettingsRegistry.h"
+#include "../include/AdcSampler.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+// Parameter names as typed on the command channel
+static const char nameScanStep[] PROGMEM = "scan_step";
+static const char nameScanDelay[] PROGMEM = "scan_delay";
+static const char nameTrackingSpeed[] PROGMEM = "tracking_speed";
+static const char namePumpAngle[] PROGMEM = "pump_angle";
+static const char namePulse[] PROGMEM = "pulse_ms";
+static const char nameSettle[] PROGMEM = "settle_ms";
+static const char nameDwell[] PROGMEM = "dwell_ms";
+static const char nameNoiseK[] PROGMEM = "noise_k";
+static const char nameFixedThreshold[] PROGMEM = "fixed_threshold";
+static const char nameLcdRefresh[] PROGMEM = "lcd_refresh";
+
+static const SettingInfo settingTable[] PROGMEM = {
+    { nameScanStep, SETTING_INT, offsetof(Settings, servo.scanStep), 1, 10 },
+    { nameScanDelay, SETTING_INT, offsetof(Settings, servo.scanDelay), 5, 500 },
+    { nameTrackingSpeed, SETTING_FLOAT, offsetof(Settings, servo.trackingSpeed), 0.01, 1.0 },
+    { namePumpAngle, SETTING_FLOAT, offsetof(Settings, pump.angleThreshold), 1.0, 30.0 },
+    { namePulse, SETTING_ULONG, offsetof(Settings, pump.pulseDuration), 200, 5000 },
+    { nameSettle, SETTING_ULONG, offsetof(Settings, pump.pulseDelay), 100, 10000 },
+    { nameDwell, SETTING_ULONG, offsetof(Settings, pump.dwellLimit), 1000, 60000 },
+    { nameNoiseK, SETTING_FLOAT, offsetof(Settings, detection.noiseMultiplier), 0.0, 20.0 },
+    { nameFixedThreshold, SETTING_INT, offsetof(Settings, detection.fixedThreshold),
+      8 << ADC_OVERSAMPLE_BITS, 1000 << ADC_OVERSAMPLE_BITS },
+    { nameLcdRefresh, SETTING_ULONG, offsetof(Settings, display.refreshInterval), 100, 10000 },
+};
+
+static const uint8_t SETTING_COUNT = sizeof(settingTable) / sizeof(settingTable[0]);
+
+// Stored in front of the settings so stale or foreign EEPROM contents are rejected
+struct SettingsHeader {
+    uint16_t magic;
+    uint8_t size;
+    uint8_t checksum;
+};
+
+#ifndef FIXED_SETTINGS
+static uint8_t fieldSize(SettingType type) {
+    switch (type) {
+        case SETTING_INT: return sizeof(int);
+        case SETTING_ULONG: return sizeof(unsigned long);
+        default: return sizeof(float);
+    }
+}
+#endif
+
+SettingsRegistry::SettingsRegistry(Settings& values, const Settings* defaultValues)
+    : settings(values), defaults(defaultValues) {}
+
+void SettingsRegistry::readInfo(uint8_t index, SettingInfo& info) const {
+    memcpy_P(&info, &settingTable[index], sizeof(SettingInfo));
+}
+
+uint8_t SettingsRegistry::count() const {
+    return SETTING_COUNT;
+}
+
+int SettingsRegistry::find(const char* name) const {
+    for (uint8_t i = 0; i < SETTING_COUNT; i++) {
+        SettingInfo info;
+        readInfo(i, info);
+        if (strcmp_P(name, info.name) == 0) return i;
+    }
+    return -1;
+}
+
+float SettingsRegistry::get(uint8_t index) const {
+    SettingInfo info;
+    readInfo(index, info);
+    const uint8_t* field = (const uint8_t*)&settings + info.offset;
+    switch (info.type) {
+        case SETTING_INT: return *(const int*)field;
+        case SETTING_ULONG: return *(const unsigned long*)field;
+        default: return *(const float*)field;
+    }
+}
+
+bool SettingsRegistry::set(uint8_t index, float value) {
+    SettingInfo info;
+    readInfo(index, info);
+    if (!(value >= info.minValue && value <= info.maxValue)) return false;
+    uint8_t* field = (uint8_t*)&settings + info.offset;
+    switch (info.type) {
+        case SETTING_INT: *(int*)field = (int)(value + 0.5); break;
+        case SETTING_ULONG: *(unsigned long*)field = (unsigned long)(value + 0.5); break;
+        default: *(float*)field = value; break;
+    }
+    return true;
+}
+
+void SettingsRegistry::print(uint8_t index, Print& out) const {
+    SettingInfo info;
+    readInfo(index, info);
+    out.print((const __FlashStringHelper*)info.name);
+    out.print(F(" = "));
+    switch (info.type) {
+        case SETTING_INT: out.print((long)get(index)); break;
+        case SETTING_ULONG: out.print((unsigned long)get(index)); break;
+        default: out.print(get(index), 3); break;
+    }
+}
+
+uint8_t SettingsRegistry::checksum(const Settings& values) {
+    const uint8_t* bytes = (const uint8_t*)&values;
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < sizeof(Settings); i++) {
+        sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ bytes[i];
+    }
+    return sum;
+}
+
+void SettingsRegistry::restoreDefaults() {
+    memcpy_P(&settings, defaults, sizeof(Settings));
+}
+
+bool SettingsRegistry::load() {
+#ifdef FIXED_SETTINGS
+    // The modules use the compiled-in values whatever is stored
+    restoreDefaults();
+    return false;
+#else
+    SettingsHeader header;
+    Settings stored;
+    EEPROM.get(SETTINGS_EEPROM_ADDRESS, header);
+    EEPROM.get(SETTINGS_EEPROM_ADDRESS + sizeof(SettingsHeader), stored);
+    if (header.magic != SETTINGS_MAGIC || header.size != sizeof(Settings) ||
+        header.checksum != checksum(stored)) {
+        restoreDefaults();
+        return false;
+    }
+    settings = stored;
+    // Ranges may have been tightened since the values were saved
+    for (uint8_t i = 0; i < SETTING_COUNT; i++) {
+        if (!set(i, get(i))) {
+            SettingInfo info;
+            readInfo(i, info);
+            memcpy_P((uint8_t*)&settings + info.offset, (const uint8_t*)defaults + info.offset,
+                     fieldSize(info.type));
+        }
+    }
+    return true;
+#endif
+}
+
+void SettingsRegistry::save() {
+    SettingsHeader header = { SETTINGS_MAGIC, sizeof(Settings), checksum(settings) };
+    // put() only rewrites bytes that changed, sparing EEPROM wear
+    EEPROM.put(SETTINGS_EEPROM_ADDRESS, header);
+    EEPROM.put(SETTINGS_EEPROM_ADDRESS + sizeof(SettingsHeader), settings);
+}
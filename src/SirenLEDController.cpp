@@ -1,26 +1,36 @@
 #include "../include/SirenLEDController.h"
 
-void SirenLEDController::setup(int led1, int led2) {
-    pin1 = led1;
-    pin2 = led2;
-    pinMode(pin1, OUTPUT);
-    pinMode(pin2, OUTPUT);
-    digitalWrite(pin1, LOW);
-    digitalWrite(pin2, LOW);
+void SirenLEDController::setup() {
+    Led1::low();
+    Led2::low();
+    Led1::output();
+    Led2::output();
+    eventBus.subscribe(EVENT_MASK(EVENT_FLAME_START) | EVENT_MASK(EVENT_FLAME_END), handleEvent, this);
 }
 
-void SirenLEDController::update(bool fireDetected) {
-    if (fireDetected) {
-        unsigned long now = millis();
-        if (now - lastToggle >= 300) { // SIREN_INTERVAL
-            state = !state;
-            digitalWrite(pin1, state ? HIGH : LOW);
-            digitalWrite(pin2, state ? LOW : HIGH);
-            lastToggle = now;
-        }
+void SirenLEDController::handleEvent(const Event& event, void* context) {
+    SirenLEDController* self = static_cast<SirenLEDController*>(context);
+    if (event.type == EVENT_FLAME_START) {
+        // Start with LED2 lit so the first toggle lights LED1
+        self->active = true;
+        Led1::low();
+        Led2::high();
+        self->lastToggle = millis() - SIREN_INTERVAL; // Toggle on the next update
     } else {
-        digitalWrite(pin1, LOW);
-        digitalWrite(pin2, LOW);
-        state = false;
+        // LEDs are only driven low once, on the falling edge
+        self->active = false;
+        Led1::low();
+        Led2::low();
     }
-}
\ No newline at end of file
+}
+
+void SirenLEDController::update() {
+    if (!active) return;
+    unsigned long now = millis();
+    if (now - lastToggle >= SIREN_INTERVAL) {
+        // LEDs are always in opposite states, so one PINx write flips each
+        Led1::toggle();
+        Led2::toggle();
+        lastToggle = now;
+    }
+}
@@ -0,0 +1,47 @@
+#include "../include/StackProbe.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_HEALTH
+
+// Symbols provided by the linker and avr-libc malloc
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char* __brkval;
+
+// Paint all SRAM above .bss with the pattern before constructors run.
+// Placed in .init3 so it executes once, right after the stack is set up.
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack() {
+  uint8_t* p = &_end;
+  while (p <= &__stack) {
+    *p++ = STACK_PAINT_PATTERN;
+  }
+}
+
+// Lowest address usable by the stack: the heap top, or the heap start if
+// nothing has been allocated yet
+static uint8_t* heapTop() {
+  return __brkval ? (uint8_t*)__brkval : &__heap_start;
+}
+
+uint16_t getStackHeadroom() {
+  // Untouched bytes remain painted; count them upward from the heap top
+  uint8_t* p = heapTop();
+  uint16_t count = 0;
+  while (p <= &__stack && *p == STACK_PAINT_PATTERN) {
+    p++;
+    count++;
+  }
+  return count;
+}
+
+uint16_t getFreeMemory() {
+  uint8_t top;
+  return &top - heapTop();
+}
+
+void printMemoryReport() {
+  LOG_DEBUG(F("Stack headroom (min free): "), getStackHeadroom(),
+            F(" bytes, free now: "), getFreeMemory(), F(" bytes"));
+}
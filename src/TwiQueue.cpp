@@ -0,0 +1,112 @@
+#include "../include/TwiQueue.h"
+#include <avr/interrupt.h>
+#include <util/twi.h>
+
+TwiQueue twiQueue;
+
+ISR(TWI_vect) {
+    twiQueue.handleInterrupt();
+}
+
+// TWCR values: acknowledge the interrupt and continue, or issue a
+// (repeated) start or stop
+#define TWCR_CONTINUE (_BV(TWEN) | _BV(TWIE) | _BV(TWINT))
+#define TWCR_START (TWCR_CONTINUE | _BV(TWSTA))
+#define TWCR_STOP (_BV(TWEN) | _BV(TWINT) | _BV(TWSTO))
+
+TwiQueue::TwiQueue()
+    : head(0), tail(0), busy(false), nackCount(0), frameRemaining(0) {}
+
+void TwiQueue::begin(unsigned long frequency) {
+    // Internal pull-ups on SDA (PC4) and SCL (PC5), as Wire did
+    PORTC |= _BV(4) | _BV(5);
+    TWSR = 0;  // Prescaler 1
+    TWBR = ((F_CPU / frequency) - 16) / 2;
+    TWCR = _BV(TWEN);
+}
+
+uint8_t TwiQueue::used() const {
+    uint8_t h = head, t = tail;
+    return h >= t ? h - t : TWI_QUEUE_SIZE - t + h;
+}
+
+bool TwiQueue::send(uint8_t address, const uint8_t* data, uint8_t length) {
+    // One slot stays empty so a full ring is distinguishable from an empty one
+    if ((unsigned int)length + 2 > (unsigned int)(TWI_QUEUE_SIZE - 1 - used())) return false;
+
+    uint8_t index = head;
+    buffer[index] = address;
+    index = next(index);
+    buffer[index] = length;
+    index = next(index);
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[index] = data[i];
+        index = next(index);
+    }
+
+    // Publishing the frame and checking for a running transfer must not be
+    // split by the interrupt deciding the queue is empty and stopping
+    noInterrupts();
+    head = index;
+    bool start = !busy;
+    busy = true;
+    interrupts();
+    if (start) {
+        while (TWCR & _BV(TWSTO)) {}  // Previous stop still on the bus
+        TWCR = TWCR_START;
+    }
+    return true;
+}
+
+void TwiQueue::flush() {
+    while (busy) {}
+    while (TWCR & _BV(TWSTO)) {}
+}
+
+// Called after a (repeated) start: address the next queued frame
+void TwiQueue::startFrame() {
+    uint8_t address = buffer[tail];
+    tail = next(tail);
+    frameRemaining = buffer[tail];
+    tail = next(tail);
+    TWDR = address << 1;  // SLA+W
+    TWCR = TWCR_CONTINUE;
+}
+
+void TwiQueue::handleInterrupt() {
+    bool failed = false;
+    switch (TW_STATUS) {
+        case TW_START:
+        case TW_REP_START:
+            startFrame();
+            return;
+        case TW_MT_SLA_ACK:
+        case TW_MT_DATA_ACK:
+            if (frameRemaining > 0) {
+                TWDR = buffer[tail];
+                tail = next(tail);
+                frameRemaining--;
+                TWCR = TWCR_CONTINUE;
+                return;
+            }
+            break;
+        default:
+            // NACK, lost arbitration or bus error: drop the rest of the frame
+            nackCount++;
+            failed = true;
+            while (frameRemaining > 0) {
+                tail = next(tail);
+                frameRemaining--;
+            }
+            break;
+    }
+
+    // Frame complete; chain the next one with a repeated start (after a
+    // failure, a stop first releases the bus)
+    if (tail != head) {
+        TWCR = failed ? (TWCR_START | _BV(TWSTO)) : TWCR_START;
+    } else {
+        TWCR = TWCR_STOP;
+        busy = false;
+    }
+}
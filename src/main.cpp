@@ -8,6 +8,24 @@
 #include "../include/AmbientMonitor.h"
 #include "../include/LCDManager.h"
 #include "../include/SirenLEDController.h"
+#include "../include/EventBus.h"
+#include "../include/PowerManager.h"
+#include "../include/StackProbe.h"
+#include "../include/FastPin.h"
+#include "../include/AdcSampler.h"
+#include "../include/SampleAligner.h"
+#include "../include/Settings.h"
+#include "../include/SettingsRegistry.h"
+#include "../include/CommandChannel.h"
+#include "../include/SensorHealth.h"
+#include "../include/RawCapture.h"
+#include "../include/BlackBox.h"
+#include "../include/BackgroundMap.h"
+#include "../include/IncidentTimeline.h"
+#include "../include/ClimateFusion.h"
+#include "../include/Log.h"
+
+#define LOG_MODULE LOG_SYSTEM
 
 // Pin definitions
 #define SENSOR1_PIN A2  // Right sensor
@@ -19,131 +37,528 @@
 #define CALIBRATION_BUTTON 2
 #define SERVO_PIN 9
 
-// Pump control relay
-#define PUMP_RELAY_PIN 6
+// Pump relay and siren LED pins are defined in PumpControl.h and SirenLEDController.h
+
+// Scan limits and the tunable settings' defaults are in the module
+// headers (ServoControl.h, PumpControl.h, FlameTriangulation.h,
+// LCDManager.h), see Settings.h
+
+// Status report period (lines are paced by the UART, see Log.h)
+#define STATUS_REPORT_INTERVAL 1000
+
+// Event parameters
+#define ANGLE_EVENT_THRESHOLD 3.0 // Publish EVENT_ANGLE_CHANGED when the angle moves more than this (degrees)
+
+// Loop profiling - uncomment to report subsystem update time over serial
+// #define LOOP_PROFILING
 
-// Siren LED pins
-#define SIREN_LED1_PIN 4
-#define SIREN_LED2_PIN 5
-#define SIREN_INTERVAL 300 // ms between siren LED toggles
+// Low-power idle sentinel - uncomment to sleep between sensor samples when idle
+// #define LOW_POWER_SENTINEL
+#define SENTINEL_ENTRY_DELAY 30000 // Milliseconds without flame before entering sentinel mode
 
-// Servo scanning parameters
-#define SCAN_MIN_ANGLE 30
-#define SCAN_MAX_ANGLE 150
-#define SCAN_STEP 1       // Degrees per step
-#define SCAN_DELAY 30     // Milliseconds between steps
-#define TRACKING_SPEED 0.1 // Lerp factor (0.0-1.0) - higher values = faster tracking
+// Raw capture - uncomment to stream ~1 kHz raw sensor triples as binary
+// frames at CAPTURE_BAUD (decode with tools/capture_decode, see RawCapture.h),
+// or build the uno_capture environment
+// #define RAW_CAPTURE
 
-// LCD refresh parameters
-#define LCD_REFRESH_INTERVAL 500  // Minimum time between LCD updates in milliseconds
+// Boot: detection runs on a provisional baseline within a few hundred ms,
+// the fine calibration follows in the background
+#define BOOT_BASELINE_FRAMES 16       // Frames averaged for the provisional baseline (~80 ms)
+// A channel this far below the last calibration's baseline (more IR) has a
+// flame in view: the drift that would take it there raises a calibration
+// warning anyway
+#define BOOT_BASELINE_MARGIN (DRIFT_WARNING_COUNTS << ADC_OVERSAMPLE_BITS)
+#define FINE_CALIBRATION_DELAY 1000   // Flame-free time before fine calibration starts (ms)
+#define FINE_CALIBRATION_SAMPLES 20   // Frames averaged for the fine calibration...
+#define FINE_CALIBRATION_INTERVAL 100 // ...one every this many ms
 
 // Ambient monitoring parameters
 #define AMBIENT_CHECK_INTERVAL 5000  // Check for ambient drift every 5 seconds
 
-// Pump control parameters
-#define PUMP_ANGLE_THRESHOLD 7.0     // Activate pump when within +/- degrees of target
-#define PUMP_PULSE_DURATION 1000      // Duration of water pulse in milliseconds
-#define PUMP_PULSE_DELAY 1000        // Delay between pulses in milliseconds
+// Compiled-in defaults for the runtime-tunable settings
+const Settings DEFAULT_SETTINGS PROGMEM = {
+  DEFAULT_SERVO_SETTINGS,
+  DEFAULT_PUMP_SETTINGS,
+  DEFAULT_DETECTION_SETTINGS,
+  DEFAULT_DISPLAY_SETTINGS
+};
 
 // Global objects
-FlameTriangulation flameSensor;
-ServoControl servoControl(
-    SERVO_PIN, SCAN_MIN_ANGLE, SCAN_MAX_ANGLE, SCAN_STEP, SCAN_DELAY, TRACKING_SPEED);
-PumpControl pumpControl(
-    PUMP_RELAY_PIN, PUMP_ANGLE_THRESHOLD, PUMP_PULSE_DURATION, PUMP_PULSE_DELAY);
+Settings settings;
+SettingsRegistry settingsRegistry(settings, &DEFAULT_SETTINGS);
+BlackBox blackBox;
+BackgroundMap backgroundMap;
+IncidentTimeline incidentTimeline;
+CommandChannel commandChannel(settingsRegistry, blackBox, incidentTimeline);
+FlameTriangulation flameSensor(settings.detection);
+ServoControl servoControl(SERVO_PIN, SCAN_MIN_ANGLE, SCAN_MAX_ANGLE, settings.servo);
+PumpControl pumpControl(settings.pump);
 AmbientMonitor ambientMonitor(AMBIENT_CHECK_INTERVAL);
-LCDManager lcdManager(LCD_REFRESH_INTERVAL);
+ClimateFusion climateFusion;
+SampleAligner sampleAligner;
+LCDManager lcdManager(settings.display);
+SensorHealth sensorHealth;
 SirenLEDController sirenLEDController;
+#ifdef LOW_POWER_SENTINEL
+PowerManager powerManager(SENTINEL_ENTRY_DELAY);
+#endif
+
+// Compile-time pin access for the status LED and calibration button
+typedef FastPin<LED_STATUS> StatusLed;
+typedef FastPin<CALIBRATION_BUTTON> CalibrationButton;
 
 // Function prototypes
 void performCalibration();
+void provisionalCalibration();
+void surveyBackground();
+void fineCalibrationStep(int reading1, int reading2, int reading3);
+bool belowStoredBaseline(const int levels[]);
+void saveBaseline();
+void publishDetectionEvents(bool flameDetected, float angle);
+void trackFireBearing(bool flameDetected, int serviceBearing);
+bool printReportLine(uint8_t line);
+void sentinelTick();
+
+// Background fine calibration after boot
+bool fineCalibrationPending = false;
+uint8_t fineCalibrationCount = 0;
+long fineCalibrationSums[3];
+unsigned long fineCalibrationNext = 0;
+
+#ifdef LOOP_PROFILING
+unsigned long profileTotalMicros = 0;
+unsigned long profileMaxMicros = 0;
+unsigned long profileLoopCount = 0;
+unsigned long profileLcdTotalMicros = 0;  // LCD refresh and flush, inside the update time
+unsigned long profileLcdMaxMicros = 0;
+unsigned long profileEventBase = 0;  // Publish count at the start of the window
+#endif
 
 void setup() {
+#ifdef RAW_CAPTURE
+  Serial.begin(CAPTURE_BAUD);
+#else
   Serial.begin(9600);
-  initializeLCD();
-  playStartupSequence();
+#endif
+  // Start-up messages are not dropped: the first 63 bytes go straight into
+  // the UART buffer, later lines wait for it to drain
+  logger.setBlocking(true);
+  // Settings first: the modules read them from here on
+  bool settingsLoaded = settingsRegistry.load();
+  LOG_INFO(F("Fire Detection Triangulation System"));
+  LOG_INFO(settingsLoaded ? F("Settings loaded from EEPROM") : F("Using default settings"));
+  // Sensing first, so frames are ready by the time the outputs are
   pinMode(SENSOR1_PIN, INPUT);
   pinMode(SENSOR2_PIN, INPUT);
   pinMode(SENSOR3_PIN, INPUT);
-  pinMode(LED_STATUS, OUTPUT);
-  pinMode(CALIBRATION_BUTTON, INPUT_PULLUP);
+  adcSampler.begin(SENSOR1_PIN, SENSOR2_PIN, SENSOR3_PIN);
+  StatusLed::output();
+  CalibrationButton::inputPullup();
   initializeBuzzer();
   servoControl.begin(90);
   pumpControl.begin();
-  sirenLEDController.setup(SIREN_LED1_PIN, SIREN_LED2_PIN);
-  Serial.println(F("Fire Detection Triangulation System"));
-  Serial.println(F("----------------------------------"));
-  Serial.println(F("Performing initial calibration..."));
-  displayCalibrationMessage();
-  performCalibration();
+  sirenLEDController.setup();
+  blackBox.begin();
+  flameSensor.attachTimeline(&incidentTimeline);
+  servoControl.attachTimeline(&incidentTimeline);
+  pumpControl.attachTimeline(&incidentTimeline);
+  initializeLCD();
+  lcdManager.begin();
+  // The provisional baseline is taken with the heading's background removed
+  if (!backgroundMap.load()) LOG_INFO(F("No background map, learning while scanning"));
+  backgroundMap.apply(servoControl.getCurrentAngle(), flameSensor);
+  provisionalCalibration();
+  // Look where the last fire was before scanning the full range
+  if (backgroundMap.getFireBearing() >= 0) {
+    servoControl.reacquire(backgroundMap.getFireBearing(), REACQUIRE_WINDOW, REACQUIRE_LEGS);
+  }
+  // The splash, melody and fine calibration run from loop()
+  playStartupSequence();
+  fineCalibrationPending = true;
+  fineCalibrationCount = 0;
+  fineCalibrationNext = millis() + FINE_CALIBRATION_DELAY;
+  LOG_INFO(F("Armed in "), millis(), F(" ms, fine calibration follows"));
+  logger.setBlocking(false);
+#ifdef RAW_CAPTURE
+  rawCapture.start();
+  adcSampler.attachCapture(&rawCapture);
+#endif
 }
 
 void loop() {
+#ifdef LOW_POWER_SENTINEL
+  if (powerManager.isSentinelActive()) {
+    sentinelTick();
+    return;
+  }
+#endif
+
   // Calibration button logic (not a subsystem)
-  if (digitalRead(CALIBRATION_BUTTON) == LOW) {
-    Serial.println(F("Recalibration requested..."));
-    digitalWrite(LED_STATUS, HIGH);
+  if (!CalibrationButton::read()) {
+    // The calibration blocks anyway; its messages wait for the UART
+    logger.setBlocking(true);
+    LOG_INFO(F("Recalibration requested..."));
+    StatusLed::high();
     displayCalibrationMessage();
     delay(500);
     performCalibration();
-    digitalWrite(LED_STATUS, LOW);
+    StatusLed::low();
+    logger.setBlocking(false);
   }
 
-  // Read sensors and update flame triangulation
-  int reading1 = analogRead(SENSOR1_PIN);
-  int reading2 = analogRead(SENSOR2_PIN);
-  int reading3 = analogRead(SENSOR3_PIN);
-  flameSensor.updateReadings(reading1, reading2, reading3);
+  // Update flame triangulation with the latest oversampled frame
+  if (adcSampler.available()) {
+    // The channels are captured in turn; bring them to one instant
+    SampleTriple triple;
+    adcSampler.read(triple);
+    int reading1, reading2, reading3;
+    sampleAligner.align(triple, reading1, reading2, reading3);
+    backgroundMap.apply(servoControl.getCurrentAngle(), flameSensor);
+    flameSensor.updateReadings(reading1, reading2, reading3);
+    // Faulty channels are masked out before the results below are read
+    sensorHealth.update(flameSensor);
+    if (fineCalibrationPending) {
+      fineCalibrationStep(reading1 - flameSensor.getBackground(0), reading2 - flameSensor.getBackground(1),
+                          reading3 - flameSensor.getBackground(2));
+    } else if (flameSensor.getTargets().count() == 0) {
+      // Learn the background only while plainly scanning
+      backgroundMap.learn(servoControl.getCurrentAngle(), flameSensor);
+    }
+  }
+
+  // Serial tuning commands; detection thresholds are derived, so refresh them
+  if (commandChannel.poll()) flameSensor.applySettings();
+
   bool flameDetected = flameSensor.isFlameDetected();
   float angle = flameDetected ? flameSensor.getFlameAngle() : 0;
 
+  // Record intensity peaks by heading to locate multiple flames
+  flameSensor.observeHeading(servoControl.getCurrentAngle());
+
+#ifdef LOOP_PROFILING
+  unsigned long profileStart = micros();
+#endif
+
+  // Publish transitions; I/O subsystems act on these edges only
+  publishDetectionEvents(flameDetected, angle);
+  blackBox.record(flameSensor, flameDetected, angle, servoControl.getCurrentAngle(),
+                  pumpControl.isPumpActive());
+  blackBox.serviceDump();
+  incidentTimeline.servicePrint();
+
   // Subsystem updates (all handle their own timing)
   ambientMonitor.update(flameSensor);
-  servoControl.update(flameDetected, angle);
-  pumpControl.update(flameDetected, servoControl.getCurrentAngle(), servoControl.getTargetAngle());
+  climateFusion.update(flameDetected, flameSensor);
+  int serviceBearing = pumpControl.selectTarget(
+      flameSensor.getTargets(), servoControl.getCurrentAngle(), flameDetected, servoControl.isSurveying());
+  if (pumpControl.takeSurveyRequest()) servoControl.startSurvey();
+  servoControl.update(flameDetected, angle, serviceBearing);
+  pumpControl.update(flameDetected && !servoControl.isSurveying(),
+                     servoControl.getCurrentAngle(), servoControl.getTargetAngle(),
+                     flameSensor.getTotalIntensity(), flameSensor.getConfidence());
+  trackFireBearing(flameDetected, serviceBearing);
+#ifdef LOOP_PROFILING
+  unsigned long lcdStart = micros();
+#endif
   lcdManager.update(flameDetected, angle, flameSensor);
-  sirenLEDController.update(flameDetected);
+  updateLCDDisplay();
+#ifdef LOOP_PROFILING
+  unsigned long lcdElapsed = micros() - lcdStart;
+  profileLcdTotalMicros += lcdElapsed;
+  if (lcdElapsed > profileLcdMaxMicros) profileLcdMaxMicros = lcdElapsed;
+#endif
+  sirenLEDController.update();
   updateBuzzer(flameDetected);
 
-  // Debug info (keep as is, or move to a DebugManager if desired)
-  static unsigned long lastDebugTime = 0;
-  if (millis() - lastDebugTime >= 1000) {
-    flameSensor.printDebugInfo();
-    lastDebugTime = millis();
-    Serial.print(F("Pump Status: "));
-    Serial.println(pumpControl.isPumpActive() ? F("ON") : F("OFF"));
+#ifdef LOOP_PROFILING
+  unsigned long profileElapsed = micros() - profileStart;
+  profileTotalMicros += profileElapsed;
+  if (profileElapsed > profileMaxMicros) profileMaxMicros = profileElapsed;
+  profileLoopCount++;
+#endif
+
+  // Status report: started every STATUS_REPORT_INTERVAL and printed a line
+  // at a time whenever the UART buffer has room, so it never stalls the loop
+  static unsigned long lastReportTime = 0;
+  static int8_t reportLine = -1;
+  if (reportLine < 0 && millis() - lastReportTime >= STATUS_REPORT_INTERVAL) {
+    lastReportTime = millis();
+    reportLine = 0;
+  }
+  while (reportLine >= 0 && logger.hasRoom()) {
+    reportLine = printReportLine(reportLine) ? reportLine + 1 : -1;
+  }
+
+#ifdef LOW_POWER_SENTINEL
+  powerManager.update(flameDetected);
+  if (powerManager.isSentinelDue() && !isBuzzerSequencePlaying()) {
+    servoControl.suspend();
+    setLCDBacklight(false);
+    adcSampler.stop();
+    powerManager.enterSentinel();
+    return;
   }
+#endif
 
-  updateLCDDisplay();
-  delay(flameDetected ? 1 : 50);
+#ifdef RAW_CAPTURE
+  rawCapture.flush(Serial);
+  delay(1); // The capture ring holds ~30 ms of samples
+#else
+  // Short delays while a tone sequence plays keep its timing
+  delay(flameDetected || isBuzzerSequencePlaying() ? 1 : 50);
+#endif
 }
 
 // Perform calibration without flame presence
 void performCalibration() {
-  Serial.println(F("Calibrating - ensure no flame is present"));
+  LOG_INFO(F("Calibrating - ensure no flame is present"));
+  // Supersedes a boot-time fine calibration still in progress
+  fineCalibrationPending = false;
   
   // Play calibration tone
   playCalibrationTone();
 
   delay(1000); // Give time to remove flame sources
   
-  // Take multiple readings and average
-  int sum1 = 0, sum2 = 0, sum3 = 0;
+  // Take multiple oversampled readings and average. The baseline is taken
+  // at this heading as it is, so the background map starts over from it.
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) flameSensor.setBackground(ch, 0);
+  long sum1 = 0, sum2 = 0, sum3 = 0;
   const int samples = 20;
   
   for (int i = 0; i < samples; i++) {
-    sum1 += analogRead(SENSOR1_PIN);
-    sum2 += analogRead(SENSOR2_PIN);
-    sum3 += analogRead(SENSOR3_PIN);
+    int reading1, reading2, reading3;
     delay(100);
+    adcSampler.waitForFrame(reading1, reading2, reading3);
+    sum1 += reading1;
+    sum2 += reading2;
+    sum3 += reading3;
   }
   
-  // Set calibration values
+  // Set calibration values; the survey measures the background against them
   flameSensor.calibrate(sum1/samples, sum2/samples, sum3/samples);
+  saveBaseline();
+  surveyBackground();
+  // New baselines: judge every sensor afresh
+  sensorHealth.reset();
   
-  Serial.println(F("Calibration complete"));
-  Serial.println();
+  LOG_INFO(F("Calibration complete"));
   
   // Play calibration finished tone
   playCalibrationFinishedTone();
-}
\ No newline at end of file
+}
+
+// Sweeps the scan range and stores each heading's background relative to
+// the baseline just calibrated, so static IR sources at fixed bearings are
+// masked from the start (see BackgroundMap.h)
+void surveyBackground() {
+  servoControl.moveTo(BackgroundMap::binHeading(0));
+  delay(500); // The servo may have to cross the whole range
+  for (uint8_t bin = 0; bin < BACKGROUND_BINS; bin++) {
+    servoControl.moveTo(BackgroundMap::binHeading(bin));
+    delay(BACKGROUND_SURVEY_SETTLE);
+    long sums[SENSOR_COUNT] = { 0, 0, 0 };
+    for (uint8_t i = 0; i < BACKGROUND_SURVEY_FRAMES; i++) {
+      int reading1, reading2, reading3;
+      adcSampler.waitForFrame(reading1, reading2, reading3);
+      sums[0] += reading1;
+      sums[1] += reading2;
+      sums[2] += reading3;
+    }
+    int offsets[SENSOR_COUNT] = {
+      (int)(sums[0] / BACKGROUND_SURVEY_FRAMES) - flameSensor.ambientLevel1,
+      (int)(sums[1] / BACKGROUND_SURVEY_FRAMES) - flameSensor.ambientLevel2,
+      (int)(sums[2] / BACKGROUND_SURVEY_FRAMES) - flameSensor.ambientLevel3
+    };
+    backgroundMap.store(bin, offsets);
+  }
+  LOG_INFO(F("Background survey complete"));
+}
+
+// Baseline from the first few frames after power-on, so detection is live
+// while the startup melody plays and the fine calibration runs. A reset in
+// the middle of an incident (a brownout as the pump relay closes) boots
+// with the fire in view; if the frames read clearly more IR than the last
+// calibration, that baseline is kept instead so the fire is detected.
+void provisionalCalibration() {
+  long sums[SENSOR_COUNT] = { 0, 0, 0 };
+  for (int i = 0; i < BOOT_BASELINE_FRAMES; i++) {
+    int reading1, reading2, reading3;
+    adcSampler.waitForFrame(reading1, reading2, reading3);
+    sums[0] += reading1 - flameSensor.getBackground(0);
+    sums[1] += reading2 - flameSensor.getBackground(1);
+    sums[2] += reading3 - flameSensor.getBackground(2);
+  }
+  int levels[SENSOR_COUNT];
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) levels[ch] = sums[ch] / BOOT_BASELINE_FRAMES;
+  if (belowStoredBaseline(levels)) {
+    backgroundMap.getBaseline(levels);
+    LOG_WARN(F("Boot readings far below the stored baseline, keeping it"));
+  }
+  flameSensor.calibrate(levels[0], levels[1], levels[2]);
+  sensorHealth.reset();
+}
+
+// True if any channel reads more IR than the stored baseline by more
+// than BOOT_BASELINE_MARGIN; false if there is none
+bool belowStoredBaseline(const int levels[]) {
+  int stored[SENSOR_COUNT];
+  if (!backgroundMap.getBaseline(stored)) return false;
+  for (uint8_t ch = 0; ch < SENSOR_COUNT; ch++) {
+    if (stored[ch] - levels[ch] > BOOT_BASELINE_MARGIN) return true;
+  }
+  return false;
+}
+
+// Keeps the baseline just calibrated for the next boot's check
+void saveBaseline() {
+  int levels[SENSOR_COUNT] = { flameSensor.ambientLevel1, flameSensor.ambientLevel2, flameSensor.ambientLevel3 };
+  backgroundMap.saveBaseline(levels);
+}
+
+// One frame of the background fine calibration: averages the same number
+// of frames at the same spacing as performCalibration(), but starts over
+// whenever a flame is detected or a channel reads far below the stored
+// baseline, so it never folds a flame into the baseline
+void fineCalibrationStep(int reading1, int reading2, int reading3) {
+  unsigned long now = millis();
+  int levels[SENSOR_COUNT] = { reading1, reading2, reading3 };
+  if (flameSensor.isFlameDetected() || belowStoredBaseline(levels)) {
+    fineCalibrationCount = 0;
+    fineCalibrationNext = now + FINE_CALIBRATION_DELAY;
+    return;
+  }
+  if ((long)(now - fineCalibrationNext) < 0) return;
+  if (fineCalibrationCount == 0) {
+    fineCalibrationSums[0] = fineCalibrationSums[1] = fineCalibrationSums[2] = 0;
+  }
+  fineCalibrationSums[0] += reading1;
+  fineCalibrationSums[1] += reading2;
+  fineCalibrationSums[2] += reading3;
+  fineCalibrationNext = now + FINE_CALIBRATION_INTERVAL;
+  if (++fineCalibrationCount < FINE_CALIBRATION_SAMPLES) return;
+
+  flameSensor.calibrate(fineCalibrationSums[0] / FINE_CALIBRATION_SAMPLES,
+                        fineCalibrationSums[1] / FINE_CALIBRATION_SAMPLES,
+                        fineCalibrationSums[2] / FINE_CALIBRATION_SAMPLES);
+  sensorHealth.reset();
+  saveBaseline();
+  fineCalibrationPending = false;
+  LOG_INFO(F("Fine calibration complete at "), now, F(" ms"));
+}
+
+// One line of the status report; false once past the last line. Lines
+// that do not apply print nothing.
+bool printReportLine(uint8_t line) {
+  if (line < FLAME_DEBUG_LINES) {
+    flameSensor.printDebugLine(line);
+    return true;
+  }
+  switch (line - FLAME_DEBUG_LINES) {
+    case 0:
+      LOG_DEBUG(F("Pump Status: "), pumpControl.isPumpActive() ? F("ON") : F("OFF"),
+                pumpControl.isExtinguished() ? F(" (target out)") : F(""),
+                F(", incident water "), pumpControl.getIncidentWaterTime(), F(" ms"));
+      return true;
+    case 1:
+      climateFusion.printStatus();
+      return true;
+    case 2:
+      if (sensorHealth.isDegraded()) sensorHealth.printStatus();
+      return true;
+    case 3:
+#ifdef RAW_CAPTURE
+      LOG_INFO(F("Capture samples lost: "), rawCapture.getLostCount());
+#endif
+      return true;
+    case 4:
+      printMemoryReport();
+      return true;
+    case 5:
+#ifdef LOOP_PROFILING
+      LOG_INFO(F("LCD us avg/max: "), profileLoopCount ? profileLcdTotalMicros / profileLoopCount : 0,
+               F("/"), profileLcdMaxMicros);
+#endif
+      return true;
+    case 6:
+#ifdef LOOP_PROFILING
+      LOG_INFO(F("Update us avg/max: "), profileLoopCount ? profileTotalMicros / profileLoopCount : 0,
+               F("/"), profileMaxMicros, F(", loops: "), profileLoopCount,
+               F(", events: "), eventBus.getPublishCount() - profileEventBase);
+      profileTotalMicros = 0;
+      profileMaxMicros = 0;
+      profileLoopCount = 0;
+      profileLcdTotalMicros = 0;
+      profileLcdMaxMicros = 0;
+      profileEventBase = eventBus.getPublishCount();
+#endif
+      return true;
+    case 7:
+      if (logger.getDropped()) LOG_INFO(F("Log lines dropped: "), logger.getDropped());
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Remembers where water went. When that flame is lost and no known target
+// is left to service, the head searches around its bearing before the
+// full scan resumes.
+void trackFireBearing(bool flameDetected, int serviceBearing) {
+  static bool wasDetected = false;
+  static bool sprayed = false;
+  if (pumpControl.isPumpActive()) {
+    backgroundMap.noteFire(servoControl.getCurrentAngle());
+    sprayed = true;
+  }
+  if (wasDetected && !flameDetected) {
+    backgroundMap.saveFire();
+    if (sprayed && serviceBearing < 0) {
+      servoControl.reacquire(backgroundMap.getFireBearing(), REACQUIRE_WINDOW, REACQUIRE_LEGS);
+    }
+    sprayed = false;
+  }
+  wasDetected = flameDetected;
+}
+
+// Publish flame edge and angle change events
+void publishDetectionEvents(bool flameDetected, float angle) {
+  static bool lastFlameState = false;
+  static float lastPublishedAngle = 0;
+
+  if (flameDetected != lastFlameState) {
+    lastFlameState = flameDetected;
+    lastPublishedAngle = angle;
+    eventBus.publish(flameDetected ? EVENT_FLAME_START : EVENT_FLAME_END, angle);
+  } else if (flameDetected && abs(angle - lastPublishedAngle) > ANGLE_EVENT_THRESHOLD) {
+    lastPublishedAngle = angle;
+    eventBus.publish(EVENT_ANGLE_CHANGED, angle);
+  }
+}
+
+#ifdef LOW_POWER_SENTINEL
+// One sleeping sample tick: wake on the watchdog, sample all channels in
+// ADC noise reduction sleep, and return to full operation on the first
+// above-threshold sample or a calibration button press
+void sentinelTick() {
+  powerManager.sleepUntilNextTick();
+
+  // Single 10-bit conversions, scaled to the oversampled range
+  int reading1 = powerManager.sampleChannel(SENSOR1_PIN) << ADC_OVERSAMPLE_BITS;
+  int reading2 = powerManager.sampleChannel(SENSOR2_PIN) << ADC_OVERSAMPLE_BITS;
+  int reading3 = powerManager.sampleChannel(SENSOR3_PIN) << ADC_OVERSAMPLE_BITS;
+  flameSensor.updateReadings(reading1, reading2, reading3);
+  ambientMonitor.update(flameSensor);
+
+  if (flameSensor.isRawSampleAboveThreshold() || flameSensor.isFlameDetected() ||
+      !CalibrationButton::read()) {
+    powerManager.exitSentinel();
+    adcSampler.begin(SENSOR1_PIN, SENSOR2_PIN, SENSOR3_PIN);
+    servoControl.resume();
+    setLCDBacklight(true);
+    return;
+  }
+
+  powerManager.reportDutyCycle();
+}
+#endif
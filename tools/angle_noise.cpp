@@ -0,0 +1,108 @@
+// Angle noise versus intensity on recorded sensor traces.
+//
+// Reads a raw 10-bit trace, forms one frame per GROUP raw samples the way
+// the firmware would, runs the real FlameTriangulation on the frames and
+// reports the frame-to-frame angle noise binned by flame intensity.
+//
+// Built twice by the Makefile to compare the single-sample path
+// (ADC_OVERSAMPLE_BITS=0) with the oversampled path (default 2 bits):
+//
+//   make && build/angle_noise_10bit trace.txt && build/angle_noise trace.txt
+//
+// Trace format: one sample per line, "A0 A1 A2" raw readings as printed by
+// examples/Sensor_Debugging.ino; lines starting with '#' are ignored.
+
+#include "host/Arduino.h"
+#include "trace.h"
+#include "../include/FlameTriangulation.h"
+
+#include <vector>
+
+#define GROUP 64            // Raw samples per frame (>= ADC_OVERSAMPLE_COUNT)
+#define CALIBRATION_FRAMES 20
+#define INTENSITY_BINS 10
+#define FRAME_MICROS 5000   // Simulated time between frames
+
+struct Bin {
+    unsigned long count;
+    double sumSquares;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s trace.txt\n", argv[0]);
+        return 1;
+    }
+    std::vector<TraceSample> trace;
+    if (!loadTrace(argv[1], trace)) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    // Build frames: average the last 4^n samples of each group and keep
+    // n extra bits; n = 0 takes a single sample, as analogRead() did
+    std::vector<TraceSample> frames;
+    for (size_t start = 0; start + GROUP <= trace.size(); start += GROUP) {
+        long sums[3] = { 0, 0, 0 };
+        for (size_t i = start + GROUP - ADC_OVERSAMPLE_COUNT; i < start + GROUP; i++) {
+            for (int c = 0; c < 3; c++) sums[c] += trace[i].reading[c];
+        }
+        TraceSample frame;
+        for (int c = 0; c < 3; c++) frame.reading[c] = sums[c] >> ADC_OVERSAMPLE_BITS;
+        frames.push_back(frame);
+    }
+    if (frames.size() <= CALIBRATION_FRAMES) {
+        fprintf(stderr, "trace too short\n");
+        return 1;
+    }
+
+    // The trace is assumed flame-free at the start, as during calibration
+    DetectionSettings detection = { DEFAULT_NOISE_MULTIPLIER, DEFAULT_FIXED_THRESHOLD };
+    FlameTriangulation flameSensor(detection);
+    long cal[3] = { 0, 0, 0 };
+    for (int i = 0; i < CALIBRATION_FRAMES; i++) {
+        for (int c = 0; c < 3; c++) cal[c] += frames[i].reading[c];
+    }
+    flameSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES,
+                          cal[2] / CALIBRATION_FRAMES);
+
+    Bin bins[INTENSITY_BINS] = {};
+    bool havePrevious = false;
+    float previousAngle = 0;
+    unsigned long detections = 0;
+    for (size_t i = CALIBRATION_FRAMES; i < frames.size(); i++) {
+        const TraceSample& f = frames[i];
+        hostAdvanceMicros(FRAME_MICROS);
+        flameSensor.updateReadings(f.reading[0], f.reading[1], f.reading[2]);
+        if (!flameSensor.isFlameDetected()) {
+            havePrevious = false;
+            continue;
+        }
+        detections++;
+        float angle = flameSensor.getFlameAngle();
+        float intensity = 0;
+        intensity = fmax(intensity, flameSensor.calculateRelativeIntensity(f.reading[0], flameSensor.ambientLevel1));
+        intensity = fmax(intensity, flameSensor.calculateRelativeIntensity(f.reading[1], flameSensor.ambientLevel2));
+        intensity = fmax(intensity, flameSensor.calculateRelativeIntensity(f.reading[2], flameSensor.ambientLevel3));
+        if (havePrevious) {
+            // Successive differences: var(a[k] - a[k-1]) = 2 var(noise)
+            int bin = (int)(intensity * INTENSITY_BINS);
+            if (bin >= INTENSITY_BINS) bin = INTENSITY_BINS - 1;
+            double d = angle - previousAngle;
+            bins[bin].count++;
+            bins[bin].sumSquares += d * d;
+        }
+        previousAngle = angle;
+        havePrevious = true;
+    }
+
+    printf("# %d-bit frames, %lu frames, %lu with flame\n",
+           ADC_SAMPLE_BITS, (unsigned long)frames.size(), detections);
+    printf("%-12s %8s %12s\n", "intensity", "frames", "noise_deg");
+    for (int b = 0; b < INTENSITY_BINS; b++) {
+        if (bins[b].count == 0) continue;
+        printf("%4.1f-%-7.1f %8lu %12.3f\n", (double)b / INTENSITY_BINS, (double)(b + 1) / INTENSITY_BINS,
+               bins[b].count, sqrt(bins[b].sumSquares / bins[b].count / 2.0));
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Generates include/BearingTable.h for FlameTriangulation's least-squares
+// bearing estimator from the shared sensor model.
+//
+// For each bearing on a fixed grid, the three sensors' responses to a
+// flame at BEARING_NOMINAL_DISTANCE are normalized to a unit vector and
+// stored in Q15. The estimator projects the measured intensities onto each
+// vector; the best projection is the least-squares fit of bearing and
+// power, since the power that minimizes the residual at a given bearing is
+// the projection itself.
+//
+//   make table    (regenerates ../include/BearingTable.h)
+
+#include "sensor_model.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define BEARING_MIN -40
+#define BEARING_MAX 40
+#define BEARING_STEP 2
+#define NOMINAL_DISTANCE 60    // cm; balances the error for flames at 30 and 120 cm
+
+int main() {
+    const double DEG = M_PI / 180.0;
+    int size = (BEARING_MAX - BEARING_MIN) / BEARING_STEP + 1;
+
+    printf("// Generated by tools/bearing_table.cpp from tools/sensor_model.cpp - do not edit.\n");
+    printf("// Unit response vectors (Q15, firmware channel order: right, left, middle)\n");
+    printf("// of the three sensors to a flame at BEARING_NOMINAL_DISTANCE, by bearing.\n");
+    printf("#ifndef BEARING_TABLE_H\n#define BEARING_TABLE_H\n\n#include <Arduino.h>\n\n");
+    printf("#define BEARING_TABLE_MIN %d\n", BEARING_MIN);
+    printf("#define BEARING_TABLE_STEP %d\n", BEARING_STEP);
+    printf("#define BEARING_TABLE_SIZE %d\n", size);
+    printf("#define BEARING_NOMINAL_DISTANCE %d\n\n", NOMINAL_DISTANCE);
+    printf("static const int16_t BEARING_TABLE[BEARING_TABLE_SIZE][3] PROGMEM = {\n");
+    for (int i = 0; i < size; i++) {
+        int bearing = BEARING_MIN + i * BEARING_STEP;
+        float response[3];
+        sensorResponse(NOMINAL_DISTANCE * sin(bearing * DEG), NOMINAL_DISTANCE * cos(bearing * DEG), 1.0f,
+                       response);
+        double norm = sqrt(response[0] * response[0] + response[1] * response[1] + response[2] * response[2]);
+        int q[3];
+        for (int c = 0; c < 3; c++) q[c] = norm > 0 ? (int)lround(response[c] / norm * 32767) : 0;
+        printf("    { %5d, %5d, %5d },  // %+d deg\n", q[0], q[1], q[2], bearing);
+    }
+    printf("};\n\n#endif // BEARING_TABLE_H\n");
+    return 0;
+}
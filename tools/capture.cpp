@@ -0,0 +1,55 @@
+#include "capture.h"
+
+uint8_t captureCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static size_t payloadBytes(uint8_t count, uint8_t width) {
+    return (30 + (size_t)(count - 1) * 3 * width + 7) / 8;
+}
+
+// LSB-first reader matching the firmware's BitWriter
+struct BitReader {
+    const uint8_t* data;
+    size_t position;
+
+    unsigned get(uint8_t width) {
+        unsigned value = 0;
+        for (uint8_t i = 0; i < width; i++, position++) {
+            if (data[position >> 3] & (1 << (position & 7))) value |= 1U << i;
+        }
+        return value;
+    }
+
+    int getSigned(uint8_t width) {
+        unsigned value = get(width);
+        if (width && (value & (1U << (width - 1)))) return (int)value - (1 << width);
+        return (int)value;
+    }
+};
+
+CaptureResult decodeCaptureFrame(const uint8_t* p, size_t left, CaptureFrame& frame) {
+    if (left < CAPTURE_FRAME_HEADER || p[0] != CAPTURE_SYNC1 || p[1] != CAPTURE_SYNC2) return CAPTURE_NO_FRAME;
+    uint8_t count = p[4];
+    uint8_t width = p[5];
+    if (count < 1 || count > CAPTURE_FRAME_SAMPLES || width > CAPTURE_MAX_DELTA_WIDTH) return CAPTURE_NO_FRAME;
+    size_t length = CAPTURE_FRAME_HEADER + payloadBytes(count, width) + 1;
+    if (left < length) return CAPTURE_TRUNCATED;
+    if (captureCrc8(p + 2, length - 3) != p[length - 1]) return CAPTURE_BAD_CRC;
+
+    frame.index = p[2] | (p[3] << 8);
+    frame.count = count;
+    frame.width = width;
+    frame.length = length;
+    BitReader reader = { p + CAPTURE_FRAME_HEADER, 0 };
+    for (int c = 0; c < 3; c++) frame.samples[0][c] = reader.get(10);
+    for (uint8_t s = 1; s < count; s++) {
+        for (int c = 0; c < 3; c++) frame.samples[s][c] = frame.samples[s - 1][c] + reader.getSigned(width);
+    }
+    return CAPTURE_FRAME;
+}
@@ -0,0 +1,33 @@
+// Raw capture frame decoding shared by capture_decode and its tests.
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "../include/RawCapture.h"
+
+#define CAPTURE_FRAME_HEADER 6     // Sync, index, count, width
+#define CAPTURE_MAX_DELTA_WIDTH 11
+
+enum CaptureResult {
+    CAPTURE_NO_FRAME,    // No sync or an impossible header: not a frame
+    CAPTURE_TRUNCATED,   // The buffer ends inside the frame
+    CAPTURE_BAD_CRC,
+    CAPTURE_FRAME
+};
+
+// One decoded frame; samples in firmware order (right, left, middle)
+struct CaptureFrame {
+    uint16_t index;
+    uint8_t count;
+    uint8_t width;
+    size_t length;       // Bytes including sync and CRC
+    int samples[CAPTURE_FRAME_SAMPLES][3];
+};
+
+// CRC-8, polynomial 0x07, initial value 0, as RawCapture's BitWriter
+uint8_t captureCrc8(const uint8_t* data, size_t length);
+
+// Decodes the frame at data if there is one; length is the number of
+// bytes available from data
+CaptureResult decodeCaptureFrame(const uint8_t* data, size_t length, CaptureFrame& frame);
+
+#endif // CAPTURE_H
@@ -0,0 +1,106 @@
+// Reassembles a raw capture stream (RAW_CAPTURE in main.cpp) into a trace.
+//
+// Reads the bytes received from the serial port, finds the frames described
+// in RawCapture.h, checks their CRC and expands the delta-coded samples.
+// Writes a trace in the "A0 A1 A2" format the other tools read. Lost
+// samples are found from the frame sequence numbers, whether the firmware
+// ring overran or a frame was corrupted on the line. Each gap is marked
+// with a "# gap" comment line. Text printed by the firmware between
+// frames is kept as "# " comment lines.
+//
+//   stty -F /dev/ttyACM0 500000 raw -echo
+//   cat /dev/ttyACM0 > capture.bin        (Ctrl-C to stop)
+//   make && build/capture_decode capture.bin > trace.txt
+//
+// Use "-" to read standard input. A summary goes to stderr.
+
+#include "host/Arduino.h"
+#include "../include/AdcSampler.h"
+#include "capture.h"
+
+#include <vector>
+
+#define MAX_TEXT_LINE 256
+
+// Capture rate in Hz for the trace header
+static const double captureRate =
+    16000000.0 / (1 << ADC_PRESCALER_BITS) / 13 / ADC_SAMPLER_CHANNELS / CAPTURE_DECIMATION;
+
+struct Stats {
+    unsigned long frames;
+    unsigned long samples;
+    unsigned long lost;
+    unsigned long gaps;
+    unsigned long crcErrors;
+    unsigned long textBytes;
+};
+
+// Firmware triple order is right (A2), left (A0), middle (A1)
+static void writeSample(FILE* out, const int* reading) {
+    fprintf(out, "%d %d %d\n", reading[1], reading[2], reading[0]);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s capture.bin|- > trace.txt\n", argv[0]);
+        return 1;
+    }
+    FILE* in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) buffer.insert(buffer.end(), chunk, chunk + n);
+    if (in != stdin) fclose(in);
+
+    printf("# raw capture, %.1f Hz per triple, A0 A1 A2\n", captureRate);
+
+    Stats stats = {};
+    bool haveIndex = false;
+    uint16_t expected = 0;
+    char text[MAX_TEXT_LINE];
+    size_t textLength = 0;
+
+    size_t pos = 0;
+    while (pos < buffer.size()) {
+        CaptureFrame decoded;
+        CaptureResult result = decodeCaptureFrame(&buffer[pos], buffer.size() - pos, decoded);
+        if (result == CAPTURE_TRUNCATED) break;   // Truncated final frame
+        if (result == CAPTURE_BAD_CRC) stats.crcErrors++;
+        if (result == CAPTURE_FRAME) {
+            uint16_t missing = decoded.index - expected;
+            if (haveIndex && missing) {
+                printf("# gap %u samples\n", missing);
+                stats.lost += missing;
+                stats.gaps++;
+            }
+            for (uint8_t s = 0; s < decoded.count; s++) writeSample(stdout, decoded.samples[s]);
+            haveIndex = true;
+            expected = decoded.index + decoded.count;
+            stats.frames++;
+            stats.samples += decoded.count;
+            pos += decoded.length;
+            continue;
+        }
+
+        // Anything outside a valid frame is firmware text (or line noise)
+        uint8_t c = buffer[pos++];
+        stats.textBytes++;
+        if (c == '\n' || textLength == MAX_TEXT_LINE - 1) {
+            text[textLength] = '\0';
+            printf("# %s\n", text);
+            textLength = 0;
+        } else if (c >= ' ' && c < 0x7F) {
+            text[textLength++] = c;
+        }
+    }
+
+    fprintf(stderr, "%lu frames, %lu samples (%.1f s), %lu lost in %lu gaps, %lu CRC errors, %lu text bytes\n",
+            stats.frames, stats.samples, stats.samples / captureRate, stats.lost, stats.gaps,
+            stats.crcErrors, stats.textBytes);
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Angle estimator accuracy against geometric ground truth.
+//
+// A point flame is placed across the field of view at several distances.
+// The shared sensor model (sensor_model.cpp) turns its position into
+// oversampled ADC frames with per-conversion noise, and a FlameTriangulation
+// that has learned the noise floor estimates the angle. Each estimator is
+// scored only where getFlameAngle would use it: weighted triangulation
+// when all three sensors detect, the dual-sensor estimate when at least
+// two do. getFlameAngle itself is scored wherever a flame is detected.
+//
+// Reports coverage, the mean and worst absolute bias over bearings and the
+// RMS error per estimator and distance, and
+// host time per estimate. Cycle counts on the target come from
+// examples/Estimator_Benchmark.ino. With --sweep, prints the bias and RMS
+// error per bearing as CSV instead.
+//
+//   make && build/estimator_bench [--sweep]
+
+#include "host/Arduino.h"
+#include "../include/FlameTriangulation.h"
+#include "sensor_model.h"
+
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <string.h>
+
+#define AMBIENT 900.0f          // 10-bit counts
+#define NOISE 2.0f              // Per-conversion sigma, 10-bit counts
+#define FLAME_POWER 120.0f      // Response on axis at SENSOR_REFERENCE_DISTANCE, 10-bit counts
+#define BEARING_LIMIT 40        // Sweep -40..40 degrees
+#define BEARING_STEP 2
+#define TRIALS 40
+#define WARMUP_FRAMES 400       // Flame-free frames for the CFAR noise estimate
+#define TIMING_CALLS 200000
+
+static const float distances[] = { 30.0f, 60.0f, 120.0f };
+
+enum Estimator { WEIGHTED, DUAL, DISPATCH, ESTIMATOR_COUNT };
+static const char* estimatorNames[ESTIMATOR_COUNT] = { "weighted", "dual", "getFlameAngle" };
+
+struct ErrorStats {
+    double sum, sumSquares;
+    long count, trials;
+    void add(double error) { sum += error; sumSquares += error * error; count++; }
+    double bias() const { return count ? sum / count : NAN; }
+    double rms() const { return count ? sqrt(sumSquares / count) : NAN; }
+};
+
+static volatile float sink;
+
+// Host nanoseconds per call of one estimator on a fixed, centred flame
+static double timeEstimator(FlameTriangulation& flameSensor, Estimator estimator) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < TIMING_CALLS; i++) {
+        switch (estimator) {
+            case WEIGHTED: sink = flameSensor.weightedAngularTriangulation(); break;
+            case DUAL: sink = flameSensor.dualSensorEstimation(); break;
+            default: sink = flameSensor.getFlameAngle(); break;
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / TIMING_CALLS;
+}
+
+int main(int argc, char** argv) {
+    bool sweep = argc > 1 && strcmp(argv[1], "--sweep") == 0;
+    std::mt19937 rng(36);
+    const float DEG = PI / 180.0;
+    const float none[3] = { 0, 0, 0 };
+    int frame[3];
+
+    // Learn the noise floor once; every trial starts from a copy
+    DetectionSettings detection = { DEFAULT_NOISE_MULTIPLIER, DEFAULT_FIXED_THRESHOLD };
+    FlameTriangulation warm(detection);
+    const int scale = 1 << ADC_OVERSAMPLE_BITS;
+    warm.calibrate(AMBIENT * scale, AMBIENT * scale, AMBIENT * scale);
+    for (int i = 0; i < WARMUP_FRAMES; i++) {
+        sensorFrame(none, AMBIENT, NOISE, rng, frame);
+        warm.updateReadings(frame[0], frame[1], frame[2]);
+    }
+
+    if (sweep) printf("distance_cm,bearing_deg,estimator,coverage,bias_deg,rms_deg\n");
+    for (float distance : distances) {
+        ErrorStats total[ESTIMATOR_COUNT] = {};
+        // Signed bias cancels across a symmetric sweep; track its magnitude per bearing
+        double biasSum[ESTIMATOR_COUNT] = {}, biasMax[ESTIMATOR_COUNT] = {};
+        int biasBearings[ESTIMATOR_COUNT] = {};
+        for (int bearing = -BEARING_LIMIT; bearing <= BEARING_LIMIT; bearing += BEARING_STEP) {
+            float x = distance * sin(bearing * DEG);
+            float y = distance * cos(bearing * DEG);
+            float response[3];
+            sensorResponse(x, y, FLAME_POWER, response);
+
+            ErrorStats stats[ESTIMATOR_COUNT] = {};
+            for (int t = 0; t < TRIALS; t++) {
+                FlameTriangulation flameSensor(warm);
+                // Fill the smoothing buffer with frames of the flame
+                for (int f = 0; f < 5; f++) {
+                    sensorFrame(response, AMBIENT, NOISE, rng, frame);
+                    flameSensor.updateReadings(frame[0], frame[1], frame[2]);
+                }
+                int detecting = 0;
+                for (uint8_t c = 0; c < SENSOR_COUNT; c++) {
+                    if (flameSensor.isChannelDetecting(c)) detecting++;
+                }
+                for (int e = 0; e < ESTIMATOR_COUNT; e++) stats[e].trials++;
+                if (detecting == 3) stats[WEIGHTED].add(flameSensor.weightedAngularTriangulation() - bearing);
+                if (detecting >= 2) stats[DUAL].add(flameSensor.dualSensorEstimation() - bearing);
+                if (detecting >= 1) stats[DISPATCH].add(flameSensor.getFlameAngle() - bearing);
+            }
+
+            for (int e = 0; e < ESTIMATOR_COUNT; e++) {
+                total[e].sum += stats[e].sum;
+                total[e].sumSquares += stats[e].sumSquares;
+                total[e].count += stats[e].count;
+                total[e].trials += stats[e].trials;
+                if (stats[e].count > 0) {
+                    double bias = fabs(stats[e].bias());
+                    biasSum[e] += bias;
+                    if (bias > biasMax[e]) biasMax[e] = bias;
+                    biasBearings[e]++;
+                }
+                if (sweep) {
+                    printf("%.0f,%d,%s,%.2f,%.2f,%.2f\n", distance, bearing, estimatorNames[e],
+                           (double)stats[e].count / stats[e].trials, stats[e].bias(), stats[e].rms());
+                }
+            }
+        }
+        if (sweep) continue;
+        for (int e = 0; e < ESTIMATOR_COUNT; e++) {
+            printf("%4.0f cm  %-14s coverage %5.1f%%  |bias| mean %5.2f max %5.2f deg  rms %5.2f deg\n",
+                   distance, estimatorNames[e], 100.0 * total[e].count / total[e].trials,
+                   biasBearings[e] ? biasSum[e] / biasBearings[e] : NAN, biasMax[e], total[e].rms());
+        }
+    }
+    if (sweep) return 0;
+
+    // Timing on a centred flame at the middle distance
+    FlameTriangulation flameSensor(warm);
+    float response[3];
+    sensorResponse(0, distances[1], FLAME_POWER, response);
+    for (int f = 0; f < 5; f++) {
+        sensorFrame(response, AMBIENT, NOISE, rng, frame);
+        flameSensor.updateReadings(frame[0], frame[1], frame[2]);
+    }
+    for (int e = 0; e < ESTIMATOR_COUNT; e++) {
+        printf("host time %-14s %6.1f ns/estimate\n", estimatorNames[e],
+               timeEstimator(flameSensor, (Estimator)e));
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Evaluation of the DHT heat cues (ClimateFusion) and of the lower
+// optical thresholds they apply.
+//
+// Climate: synthetic DHT11 traces, a reading every DHT_READ_INTERVAL in
+// whole degrees and percent, for a fire in the room and for the changes a
+// room sees without one: heating, sun on the enclosure, a draught, a
+// shower next door, a kettle. Humidity follows the temperature with the
+// water content of the air held constant, unless the scenario adds
+// moisture. For each, the time from onset to the first cue and the share
+// of readings with a cue.
+//
+// Detection: the real FlameTriangulation in the environments of roc, with
+// 0, 1 and 2 cues applied. False alarms per hour of flame-free frames,
+// and the time to detect a flame that grows from nothing to full strength
+// over FLAME_GROWTH_MS.
+//
+// Recorded traces: serial logs with the firmware's "DHT Update" lines
+// (LOG_DISPLAY at DEBUG) are replayed through ClimateFusion, one line of
+// statistics per file.
+//
+//   make && build/heat_fusion [serial.log ...]
+
+#include "host/Arduino.h"
+#include "../include/ClimateFusion.h"
+#include "../include/LCD.h"
+#include "sensor_model.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CLIMATE_MINUTES 40         // Length of each synthetic climate trace
+#define ONSET_MINUTES 10           // Change starts after the EMAs have settled
+#define DHT_NOISE 0.3f             // Sensor noise before rounding, degrees or percent
+
+#define FRAME_MICROS 5000          // 200 Hz frames
+#define CALIBRATION_FRAMES 20
+#define WARMUP_FRAMES 400
+#define FALSE_ALARM_HOURS 1        // Flame-free time per environment and cue count
+#define FLAME_GROWTH_MS 30000UL
+#define FLAME_TRIALS 200
+
+// Host stand-in for the DHT readings the firmware takes (LCD.cpp)
+bool updateDHTReadings() { return false; }
+float getTemperature() { return 0; }
+float getHumidity() { return 0; }
+
+// --- Climate ---
+
+struct ClimateScenario {
+    const char* name;
+    bool fire;
+    // Temperature and added humidity at t seconds after onset
+    float (*temperature)(float t);
+    float (*moisture)(float t);
+};
+
+static float none(float) { return 0; }
+static float ramp(float t, float rate, float limit) { return std::min(t * rate, limit); }
+static float fireNear(float t) { return ramp(t, 6.0f / 60, 15); }
+static float fireFar(float t) { return ramp(t, 1.5f / 60, 8); }
+static float heating(float t) { return ramp(t, 0.2f / 60, 4); }
+static float sun(float t) { return ramp(t, 0.4f / 60, 6); }
+static float draught(float t) {
+    if (t < 60) return -ramp(t, 3.0f / 60, 3);
+    if (t < 180) return -3;
+    return -3 + ramp(t - 180, 3.0f / 60, 3);
+}
+static float kettle(float t) { return t < 180 ? ramp(t, 2.0f / 180, 2) : 2 - ramp(t - 180, 2.0f / 600, 2); }
+static float steam(float t) { return t < 300 ? ramp(t, 20.0f / 300, 20) : 20 - ramp(t - 300, 20.0f / 1200, 20); }
+static float kettleSteam(float t) { return t < 180 ? ramp(t, 10.0f / 180, 10) : 10 - ramp(t - 180, 10.0f / 600, 10); }
+
+static const ClimateScenario climates[] = {
+    { "fire 1 m", true, fireNear, none },
+    { "fire 3 m", true, fireFar, none },
+    { "heating", false, heating, none },
+    { "sun", false, sun, none },
+    { "draught", false, draught, none },
+    { "shower", false, none, steam },
+    { "kettle", false, kettle, kettleSteam },
+};
+
+// Saturation vapour pressure (Magnus), hPa
+static float saturation(float temperature) {
+    return 6.112f * expf(17.62f * temperature / (243.12f + temperature));
+}
+
+static void evaluateClimate(const ClimateScenario& scenario, std::mt19937& rng) {
+    std::normal_distribution<float> noise(0.0f, DHT_NOISE);
+    const float roomTemperature = 21.0f, roomHumidity = 45.0f;
+    ClimateFusion fusion;
+    int readings = 0, cued = 0, maxCues = 0;
+    float firstCue = -1;
+    for (unsigned long ms = 0; ms < CLIMATE_MINUTES * 60000UL; ms += DHT_READ_INTERVAL) {
+        float t = ms / 1000.0f - ONSET_MINUTES * 60;
+        float temperature = roomTemperature + (t >= 0 ? scenario.temperature(t) : 0);
+        float humidity = roomHumidity * saturation(roomTemperature) / saturation(temperature) +
+                         (t >= 0 ? scenario.moisture(t) : 0);
+        int cues = fusion.observe(roundf(temperature + noise(rng)), roundf(humidity + noise(rng)));
+        if (t < 0) continue;
+        readings++;
+        if (cues > 0) cued++;
+        if (cues > 0 && firstCue < 0) firstCue = t;
+        maxCues = std::max(maxCues, cues);
+    }
+    printf("%-9s %-5s %9s %7.1f%% %5d\n", scenario.name, scenario.fire ? "fire" : "-",
+           firstCue < 0 ? "-" : std::to_string((int)firstCue).c_str(), 100.0f * cued / readings, maxCues);
+}
+
+// --- Recorded traces ---
+
+static void replayLog(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return;
+    }
+    ClimateFusion fusion;
+    char line[256];
+    int readings = 0, cued = 0, maxCues = 0, firstCue = -1, maxRise = 0, maxDrop = 0;
+    while (fgets(line, sizeof(line), file)) {
+        const char* text = strstr(line, "DHT Update - Temp: ");
+        const char* humidityText = text ? strstr(text, "Humidity: ") : nullptr;
+        if (!humidityText) continue;
+        float temperature = atof(text + strlen("DHT Update - Temp: "));
+        float humidity = atof(humidityText + strlen("Humidity: "));
+        int cues = fusion.observe(temperature, humidity);
+        if (cues > 0) cued++;
+        if (cues > 0 && firstCue < 0) firstCue = readings;
+        maxCues = std::max(maxCues, cues);
+        maxRise = std::max(maxRise, fusion.getRise());
+        maxDrop = std::max(maxDrop, fusion.getHumidityDrop());
+        readings++;
+    }
+    fclose(file);
+    printf("%s: %d readings, cues on %.1f%% (max %d), first at reading %d, max rise %.1f C, max drop %.1f %%\n",
+           path, readings, readings ? 100.0f * cued / readings : 0.0f, maxCues, firstCue, maxRise / 10.0f,
+           maxDrop / 10.0f);
+}
+
+// --- Detection ---
+
+struct Environment {
+    const char* name;
+    float ambient;       // 10-bit counts
+    float noise;         // Frame noise sigma, 10-bit counts
+    float drift;         // Slow ambient wander amplitude, 10-bit counts
+    float flame;         // Full-grown flame response, 10-bit counts
+};
+
+// As roc, with the flame at the weak end of its range
+static const Environment environments[] = {
+    { "sunlit", 650, 10.0, 8.0, 60 },
+    { "dark", 960, 1.5, 0.5, 20 },
+};
+
+// Runs the detector for frames after calibrating and warming up on
+// flame-free frames; returns the number of detection onsets and the first
+// onset's frame (or -1). flameShare(frame) gives the flame's share of full
+// strength.
+template <typename FlameShare>
+static int runDetector(const Environment& env, uint8_t cues, long frames, FlameShare flameShare,
+                       std::mt19937& rng, long& firstOnset) {
+    std::normal_distribution<float> noise(0.0f, env.noise);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    const int scale = 1 << ADC_OVERSAMPLE_BITS;
+    float phase = uniform(rng) * 2 * PI;
+    float gains[3];
+    sensorGains(-30.0f + 60.0f * uniform(rng), 50.0f, gains);
+
+    FlameTriangulation flameSensor(DEFAULT_DETECTION_SETTINGS);
+    long cal[3] = { 0, 0, 0 };
+    int onsets = 0;
+    bool wasDetected = false;
+    firstOnset = -1;
+    for (long f = 0; f < CALIBRATION_FRAMES + WARMUP_FRAMES + frames; f++) {
+        long window = f - CALIBRATION_FRAMES - WARMUP_FRAMES;
+        float ambient = env.ambient + env.drift * sinf(phase + f * 0.01f);
+        float flame = window >= 0 ? env.flame * flameShare(window) : 0.0f;
+        int r[3];
+        for (int c = 0; c < 3; c++) {
+            float value = ambient + noise(rng) - flame * gains[c];
+            r[c] = constrain((int)lround(value * scale), 0, ADC_SAMPLE_MAX);
+        }
+        hostAdvanceMicros(FRAME_MICROS);
+        if (f < CALIBRATION_FRAMES) {
+            for (int c = 0; c < 3; c++) cal[c] += r[c];
+            if (f == CALIBRATION_FRAMES - 1) {
+                flameSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES,
+                                      cal[2] / CALIBRATION_FRAMES);
+            }
+            continue;
+        }
+        flameSensor.updateReadings(r[0], r[1], r[2]);
+        // The cues come long after the noise statistics have settled
+        if (window == 0) flameSensor.setHeatCues(cues);
+        bool detected = flameSensor.isFlameDetected();
+        if (window >= 0 && detected && !wasDetected) {
+            if (firstOnset < 0) firstOnset = window;
+            onsets++;
+        }
+        wasDetected = detected;
+    }
+    return onsets;
+}
+
+static void evaluateDetection(const Environment& env, uint8_t cues) {
+    const long framesPerHour = 3600L * 1000000 / FRAME_MICROS;
+    std::mt19937 rng(4242);
+    long first;
+    int falseAlarms = 0;
+    for (int h = 0; h < FALSE_ALARM_HOURS; h++) {
+        falseAlarms += runDetector(env, cues, framesPerHour, [](long) { return 0.0f; }, rng, first);
+    }
+
+    const long growthFrames = FLAME_GROWTH_MS * 1000 / FRAME_MICROS;
+    std::vector<long> latencies;
+    int missed = 0;
+    for (int t = 0; t < FLAME_TRIALS; t++) {
+        runDetector(env, cues, growthFrames,
+                    [growthFrames](long frame) { return (float)frame / growthFrames; }, rng, first);
+        if (first < 0) missed++;
+        else latencies.push_back(first * FRAME_MICROS / 1000);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    long median = latencies.empty() ? -1 : latencies[latencies.size() / 2];
+    long p95 = latencies.empty() ? -1 : latencies[latencies.size() * 95 / 100];
+    printf("%-7s %4d %8.1f %9ld %9ld %6d\n", env.name, cues, (float)falseAlarms / FALSE_ALARM_HOURS,
+           median, p95, missed);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) replayLog(argv[i]);
+        return 0;
+    }
+
+    printf("climate   fire  first cue s   cued  max\n");
+    std::mt19937 rng(2024);
+    for (const ClimateScenario& scenario : climates) evaluateClimate(scenario, rng);
+
+    printf("\nenv     cues  false/h  detect p50 ms  p95 ms  missed\n");
+    for (const Environment& env : environments) {
+        for (uint8_t cues = 0; cues <= 2; cues++) evaluateDetection(env, cues);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Minimal Arduino API for building firmware modules on the host.
+// Only what the modules linked by the tools in this directory use.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+
+using std::abs;
+using std::min;
+using std::max;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+
+#define PI 3.1415926535897932384626433832795
+#define DEC 10
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Flash is ordinary memory on the host
+#define PROGMEM
+#define PSTR(string_literal) (string_literal)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+
+// Interrupts do not exist on the host
+#define cli()
+#define sei()
+extern uint8_t SREG;
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+// Simulated clock, advanced explicitly by the host program
+unsigned long millis();
+unsigned long micros();
+void hostSetMicros(unsigned long us);
+void hostAdvanceMicros(unsigned long us);
+void delay(unsigned long ms);
+
+// AVR port registers used by FastPin
+extern volatile uint8_t PORTB, PORTC, PORTD;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PINB, PINC, PIND;
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// Pins and tones are accepted and ignored; FastPin uses the registers above
+void pinMode(uint8_t pin, uint8_t mode);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// Declared by LCD.h; no host module uses it
+class String;
+
+// Byte sink interface used by the capture encoder
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t print(const __FlashStringHelper* s);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+    size_t println() { return print("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int fmt) { size_t n = print(value, fmt); return n + println(); }
+};
+
+// Serial output goes to stdout only when enabled with hostSerialEnable(true).
+// Unit tests can instead queue input, collect the output and set the free
+// transmit buffer space the firmware sees (63 bytes, an empty buffer, by
+// default). Captured output fills that space, as if nothing were sent until
+// the next hostSetSerialRoom
+class HostSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    int available();
+    int read();
+    int availableForWrite();
+    size_t write(uint8_t value);
+    using Print::write;
+};
+extern HostSerial Serial;
+void hostSerialEnable(bool enabled);
+void hostSerialInput(const char* text);
+void hostSerialCapture(bool enabled);
+std::string hostSerialTake();        // Captured output since the last call
+void hostSetSerialRoom(int bytes);
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,28 @@
+// Host stand-in for the EEPROM library: erased (0xFF) memory per process.
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include "Arduino.h"
+
+#define HOST_EEPROM_SIZE 1024
+
+class HostEEPROM {
+public:
+    HostEEPROM() { memset(data, 0xFF, sizeof(data)); }
+    uint8_t read(int address) { return data[address]; }
+    void update(int address, uint8_t value) { data[address] = value; }
+    template <typename T> T& get(int address, T& value) {
+        memcpy(&value, data + address, sizeof(T));
+        return value;
+    }
+    template <typename T> const T& put(int address, const T& value) {
+        memcpy(data + address, &value, sizeof(T));
+        return value;
+    }
+private:
+    uint8_t data[HOST_EEPROM_SIZE];
+};
+
+static HostEEPROM EEPROM;
+
+#endif // HOST_EEPROM_H
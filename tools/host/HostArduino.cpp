@@ -0,0 +1,89 @@
+#include "Arduino.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+HostSerial Serial;
+
+volatile uint8_t PORTB, PORTC, PORTD;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PINB, PINC, PIND;
+uint8_t SREG;
+
+// Per thread, so tools can run independent firmware instances in parallel
+static thread_local unsigned long hostMicros = 0;
+static bool serialEnabled = false;
+
+unsigned long millis() { return hostMicros / 1000; }
+unsigned long micros() { return hostMicros; }
+void hostSetMicros(unsigned long us) { hostMicros = us; }
+void hostAdvanceMicros(unsigned long us) { hostMicros += us; }
+void delay(unsigned long ms) { hostMicros += ms * 1000; }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void tone(uint8_t, unsigned int, unsigned long) {}
+void noTone(uint8_t) {}
+
+static std::string serialInput;
+static size_t serialInputPosition = 0;
+static bool serialCapture = false;
+static std::string serialOutput;
+static int serialRoom = 63;
+
+void hostSerialEnable(bool enabled) { serialEnabled = enabled; }
+
+void hostSerialInput(const char* text) { serialInput += text; }
+
+void hostSerialCapture(bool enabled) { serialCapture = enabled; }
+
+std::string hostSerialTake() {
+    std::string output;
+    output.swap(serialOutput);
+    return output;
+}
+
+void hostSetSerialRoom(int bytes) { serialRoom = bytes; }
+
+int HostSerial::available() { return (int)(serialInput.size() - serialInputPosition); }
+
+int HostSerial::read() {
+    if (serialInputPosition >= serialInput.size()) return -1;
+    return (uint8_t)serialInput[serialInputPosition++];
+}
+
+int HostSerial::availableForWrite() { return serialRoom; }
+
+size_t HostSerial::write(uint8_t value) {
+    if (serialCapture) {
+        serialOutput += (char)value;
+        if (serialRoom > 0) serialRoom--;
+    }
+    if (serialEnabled && value != '\r') putchar(value);
+    return 1;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+}
+
+static size_t format(Print& out, const char* fmt, ...) {
+    char text[64];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if (n <= 0) return 0;
+    return out.write((const uint8_t*)text, strlen(text));
+}
+
+size_t Print::print(const __FlashStringHelper* s) { return print(reinterpret_cast<const char*>(s)); }
+size_t Print::print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(long n, int base) { return base == 16 ? format(*this, "%lx", n) : format(*this, "%ld", n); }
+size_t Print::print(unsigned long n, int base) { return base == 16 ? format(*this, "%lx", n) : format(*this, "%lu", n); }
+size_t Print::print(double n, int digits) { return format(*this, "%.*f", digits, n); }
@@ -0,0 +1,125 @@
+// Host stand-ins for the firmware modules that drive hardware directly:
+// the interrupt-driven ADC sampler, the I2C LCD and DHT, and the stack
+// probe. The rest of the firmware, main.cpp included, links unchanged
+// against these.
+#include "HostPeripherals.h"
+#include "../../include/AdcSampler.h"
+#include "../../include/LCD.h"
+#include "../../include/StackProbe.h"
+
+// --- AdcSampler: one frame per period of the real conversion sequence ---
+
+// 13 ADC clocks per conversion at 16 MHz / 2^ADC_PRESCALER_BITS
+#define HOST_ADC_FRAME_MICROS \
+    (13UL * (1 << ADC_PRESCALER_BITS) * ADC_SAMPLER_CHANNELS * ADC_OVERSAMPLE_COUNT / 16)
+
+AdcSampler adcSampler;
+
+static HostFrameSource frameSource = nullptr;
+static unsigned long samplerStart = 0;
+static unsigned long lastFrameRead = 0;
+
+void hostSetFrameSource(HostFrameSource source) { frameSource = source; }
+
+static unsigned long framesSinceStart() {
+    return (micros() - samplerStart) / HOST_ADC_FRAME_MICROS;
+}
+
+AdcSampler::AdcSampler()
+    : hasFrame(false), hasPrevious(false), currentChannel(0), sampleCount(0), frameReady(false), running(false),
+      capture(nullptr), captureDivider(0) {}
+
+void AdcSampler::begin(uint8_t, uint8_t, uint8_t) {
+    running = true;
+    samplerStart = micros();
+    lastFrameRead = 0;
+    hasFrame = false;
+}
+
+void AdcSampler::stop() { running = false; }
+
+bool AdcSampler::isRunning() const { return running; }
+
+// A frame is ready once a full conversion sequence has elapsed since the
+// last read; like the real sampler, frames not read in time are lost
+bool AdcSampler::available() const {
+    return running && framesSinceStart() > lastFrameRead;
+}
+
+void AdcSampler::read(int& reading1, int& reading2, int& reading3) {
+    int readings[3] = { 0, 0, 0 };
+    if (frameSource) frameSource(readings);
+    reading1 = readings[0];
+    reading2 = readings[1];
+    reading3 = readings[2];
+    lastFrameRead = framesSinceStart();
+}
+
+// The model's channels are captured at the same instant. Only frames that
+// are read are generated, so the previous frame is the last one read
+void AdcSampler::read(SampleTriple& triple) {
+    read(triple.reading[0], triple.reading[1], triple.reading[2]);
+    for (uint8_t i = 0; i < ADC_SAMPLER_CHANNELS; i++) {
+        triple.stamp[i] = (uint16_t)micros();
+        triple.previous[i] = previousFrame[i];
+        triple.previousStamp[i] = previousStamps[i];
+        previousFrame[i] = triple.reading[i];
+        previousStamps[i] = triple.stamp[i];
+    }
+    triple.hasPrevious = hasFrame;
+    hasFrame = true;
+}
+
+void AdcSampler::waitForFrame(int& reading1, int& reading2, int& reading3) {
+    if (!available()) {
+        unsigned long elapsed = micros() - samplerStart;
+        hostAdvanceMicros(HOST_ADC_FRAME_MICROS - elapsed % HOST_ADC_FRAME_MICROS);
+    }
+    read(reading1, reading2, reading3);
+}
+
+void AdcSampler::attachCapture(RawCapture* capture) { this->capture = capture; }
+void AdcSampler::handleConversion(uint16_t) {}
+void AdcSampler::startConversion() {}
+
+// --- LCD: screen updates are accepted and dropped ---
+
+void initializeLCD() {}
+void updateLCDDisplay() {}
+void updateLCD(bool, float) {}
+void displayCalibrationMessage() {}
+void setLCDBacklight(bool) {}
+void initializeDHT() {}
+void updateLCDWithTempHumidity(bool, float) {}
+void updateLCDWithCalibrationStatus(bool, float, bool, int, int, int, float, float, float) {}
+void displaySensorFault(uint8_t) {}
+
+// --- DHT: a reading every DHT_READ_INTERVAL of the climate set by the tool ---
+
+static float climateTemperature = 22.0f;
+static float climateHumidity = 45.0f;
+static float dhtTemperature = 22.0f;
+static float dhtHumidity = 45.0f;
+static unsigned long lastDHTRead = 0;
+
+void hostSetClimate(float temperature, float humidity) {
+    climateTemperature = temperature;
+    climateHumidity = humidity;
+}
+
+bool updateDHTReadings() {
+    if (millis() - lastDHTRead < DHT_READ_INTERVAL) return false;
+    lastDHTRead = millis();
+    dhtTemperature = roundf(climateTemperature);
+    dhtHumidity = roundf(climateHumidity);
+    return true;
+}
+
+float getTemperature() { return dhtTemperature; }
+float getHumidity() { return dhtHumidity; }
+
+// --- Stack probe: no SRAM to measure ---
+
+uint16_t getStackHeadroom() { return 0; }
+uint16_t getFreeMemory() { return 0; }
+void printMemoryReport() {}
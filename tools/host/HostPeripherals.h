@@ -0,0 +1,16 @@
+// Host stand-ins for the ADC sampler, LCD, DHT and stack probe (HostPeripherals.cpp).
+#ifndef HOST_PERIPHERALS_H
+#define HOST_PERIPHERALS_H
+
+#include "Arduino.h"
+
+// Called whenever the firmware reads a sensor frame; fills the three
+// oversampled readings in firmware order (right, left, middle)
+typedef void (*HostFrameSource)(int readings[3]);
+void hostSetFrameSource(HostFrameSource source);
+
+// Climate the DHT reports from the next reading on (whole degrees C and
+// percent RH, as a DHT11); a constant room until set
+void hostSetClimate(float temperature, float humidity);
+
+#endif // HOST_PERIPHERALS_H
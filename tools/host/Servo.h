@@ -0,0 +1,20 @@
+// Host stand-in for the Servo library: records the commanded angle.
+#ifndef HOST_SERVO_H
+#define HOST_SERVO_H
+
+#include "Arduino.h"
+
+class Servo {
+public:
+    Servo() : angle(90), isAttached(false) {}
+    uint8_t attach(int) { isAttached = true; return 0; }
+    void detach() { isAttached = false; }
+    bool attached() { return isAttached; }
+    void write(int value) { angle = value; }
+    int read() { return angle; }
+private:
+    int angle;
+    bool isAttached;
+};
+
+#endif // HOST_SERVO_H
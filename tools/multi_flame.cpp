@@ -0,0 +1,207 @@
+// Two-flame suppression simulation.
+//
+// Runs the firmware's FlameTriangulation, ServoControl and PumpControl with
+// the main loop's scheduling against a simple plant: the sensors turn with
+// the servo head (slew limited), each flame weakens while the water jet is
+// on it and slowly regrows otherwise. Each randomized scenario lights two
+// flames at least 40 degrees apart and measures the time until every
+// reachable flame is out and the water used before and after that point
+// (the embers of a flame that is out still glow in the sensors' band),
+// comparing dwell-limited servicing with staying on a target until it is
+// out (the previous single-target behaviour).
+//
+//   make && build/multi_flame [scenarios]
+
+#include "host/Arduino.h"
+#include "../include/FlameTriangulation.h"
+#include "../include/ServoControl.h"
+#include "../include/PumpControl.h"
+#include "sensor_model.h"
+
+#include <random>
+#include <vector>
+
+#define SIM_LIMIT_MS 180000UL
+#define IGNITION_MS 5000UL      // Flame-free lead-in so the noise estimate settles
+#define FRAME_MS 5
+#define AMBIENT 900.0f          // 10-bit counts
+#define NOISE 2.0f
+#define FLAME_DISTANCE 100.0f   // cm
+#define SERVO_SLEW_DEG_PER_MS 0.4f
+#define JET_HALF_WIDTH 6.0f     // Degrees around the heading that the water reaches
+#define SUPPRESS_RATE 0.05f     // Counts per ms of water on a flame
+#define REGROW_RATE 0.002f      // Counts per ms without water
+#define OUT_LEVEL 20.0f         // Flame is out below this strength
+#define EMBER_DECAY_MS 20000.0f // Embers of a flame that is out keep glowing, fading with this time constant
+#define TAIL_MS 30000UL         // Time simulated after the last flame is out
+
+struct SimFlame {
+    float bearing;
+    float strength;
+    float maxStrength;
+    bool shielded;              // Water does not reach it (behind an obstacle)
+    unsigned long outTime;      // 0 while burning
+};
+
+struct Result {
+    bool suppressed;
+    unsigned long detectTime;
+    unsigned long allOutTime;
+    unsigned long waterMs;
+    unsigned long wastedMs;     // Relay time after every reachable flame was out
+};
+
+static Result runScenario(std::vector<SimFlame> flames, int startAngle, unsigned long dwellLimit,
+                          std::mt19937& rng) {
+    std::normal_distribution<float> noise(0.0f, NOISE);
+    const int scale = 1 << ADC_OVERSAMPLE_BITS;
+    hostSetMicros(0);
+
+    // Firmware defaults apart from the dwell limit under test
+    Settings settings = {
+        { 1, 30, 0.1 },
+        { 7.0, 1000, 1000, dwellLimit },
+        { DEFAULT_NOISE_MULTIPLIER, DEFAULT_FIXED_THRESHOLD },
+        { 500 }
+    };
+    FlameTriangulation flameSensor(settings.detection);
+    ServoControl servoControl(9, 30, 150, settings.servo);
+    PumpControl pumpControl(settings.pump);
+    servoControl.begin(startAngle);
+    pumpControl.begin();
+    flameSensor.calibrate(AMBIENT * scale, AMBIENT * scale, AMBIENT * scale);
+
+    float head = startAngle;
+    unsigned long nextLoop = 0;
+    Result result = { false, 0, 0, 0, 0 };
+    unsigned long end = SIM_LIMIT_MS;
+    int reading[3] = { 0, 0, 0 };
+    bool frameReady = false;
+
+    for (unsigned long t = 0; t < end; t++) {
+        hostSetMicros(t * 1000UL);
+
+        // Plant: servo slew, sensor frames, water
+        float command = servoControl.getCurrentAngle();
+        head += constrain(command - head, -SERVO_SLEW_DEG_PER_MS, SERVO_SLEW_DEG_PER_MS);
+        if (t % FRAME_MS == 0) {
+            float signal[3] = { 0, 0, 0 };
+            for (const SimFlame& f : flames) {
+                if (t < IGNITION_MS) continue;
+                // Hot embers keep radiating in the sensors' band for a while
+                float emission = f.outTime ? OUT_LEVEL * expf(-(float)(t - f.outTime) / EMBER_DECAY_MS) : f.strength;
+                float gains[3];
+                sensorGains(head - f.bearing, FLAME_DISTANCE, gains);
+                for (int c = 0; c < 3; c++) signal[c] += emission * gains[c];
+            }
+            for (int c = 0; c < 3; c++) {
+                reading[c] = constrain((int)lround((AMBIENT - signal[c] + noise(rng)) * scale), 0, ADC_SAMPLE_MAX);
+            }
+            frameReady = true;
+        }
+        bool spraying = pumpControl.isPumpActive();
+        if (spraying) {
+            if (result.suppressed) result.wastedMs++;
+            else result.waterMs++;
+        }
+        bool allOut = true;
+        for (SimFlame& f : flames) {
+            if (t < IGNITION_MS) {
+                allOut = false;
+                continue;
+            }
+            if (f.outTime) continue;
+            if (spraying && !f.shielded && fabsf(head - f.bearing) <= JET_HALF_WIDTH) {
+                f.strength -= SUPPRESS_RATE;
+            } else if (f.strength < f.maxStrength) {
+                f.strength += REGROW_RATE;
+            }
+            if (f.strength < OUT_LEVEL) f.outTime = t;
+            else if (!f.shielded) allOut = false;
+        }
+        if (allOut && !result.suppressed) {
+            result.suppressed = true;
+            result.allOutTime = t - IGNITION_MS;
+            end = t + TAIL_MS;
+        }
+
+        // Firmware main loop, at the rate loop() runs
+        if (t < nextLoop) continue;
+        if (frameReady) {
+            flameSensor.updateReadings(reading[0], reading[1], reading[2]);
+            frameReady = false;
+        }
+        bool flameDetected = flameSensor.isFlameDetected();
+        float angle = flameDetected ? flameSensor.getFlameAngle() : 0;
+        if (flameDetected && !result.detectTime) result.detectTime = t - IGNITION_MS;
+        flameSensor.observeHeading(servoControl.getCurrentAngle());
+        int serviceBearing = pumpControl.selectTarget(
+            flameSensor.getTargets(), servoControl.getCurrentAngle(), flameDetected, servoControl.isSurveying());
+        if (pumpControl.takeSurveyRequest()) servoControl.startSurvey();
+        servoControl.update(flameDetected, angle, serviceBearing);
+        pumpControl.update(flameDetected && !servoControl.isSurveying(),
+                           servoControl.getCurrentAngle(), servoControl.getTargetAngle(),
+                           flameSensor.getTotalIntensity(), flameSensor.getConfidence());
+        nextLoop = t + (flameDetected ? 1 : 50);
+    }
+    return result;
+}
+
+static void summarize(const char* scenario, const char* policy, const std::vector<Result>& results) {
+    int suppressed = 0;
+    double sumOut = 0, sumDetect = 0, sumWater = 0, sumWasted = 0;
+    unsigned long maxOut = 0;
+    for (const Result& r : results) {
+        sumDetect += r.detectTime;
+        if (!r.suppressed) continue;
+        suppressed++;
+        sumOut += r.allOutTime;
+        sumWater += r.waterMs;
+        sumWasted += r.wastedMs;
+        if (r.allOutTime > maxOut) maxOut = r.allOutTime;
+    }
+    printf("%-9s %-9s suppressed %3d/%zu  detect %4.2fs  out mean %6.2fs max %6.2fs  water %5.2fs + %5.2fs after\n",
+           scenario, policy, suppressed, results.size(), sumDetect / results.size() / 1000.0,
+           suppressed ? sumOut / suppressed / 1000.0 : 0.0, maxOut / 1000.0,
+           suppressed ? sumWater / suppressed / 1000.0 : 0.0, suppressed ? sumWasted / suppressed / 1000.0 : 0.0);
+}
+
+int main(int argc, char** argv) {
+    int scenarios = argc > 1 ? atoi(argv[1]) : 100;
+    const unsigned long dwellLimits[] = { 4000, 8000, SIM_LIMIT_MS };
+    const char* policies[] = { "dwell 4s", "dwell 8s", "stay" };
+    const int policyCount = sizeof(dwellLimits) / sizeof(dwellLimits[0]);
+
+    // "open": both flames reachable. "shielded": the stronger flame, which
+    // is serviced first, cannot be put out; time is to put out the other.
+    for (int shielded = 0; shielded < 2; shielded++) {
+        std::mt19937 scenarioRng(2024);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        std::vector<Result> results[policyCount];
+        for (int s = 0; s < scenarios; s++) {
+            std::vector<SimFlame> flames(2);
+            do {
+                flames[0].bearing = 40 + 100 * uniform(scenarioRng);
+                flames[1].bearing = 40 + 100 * uniform(scenarioRng);
+            } while (fabsf(flames[0].bearing - flames[1].bearing) < 40);
+            for (SimFlame& f : flames) {
+                f.strength = f.maxStrength = 150 + 250 * uniform(scenarioRng);
+                f.outTime = 0;
+                f.shielded = false;
+            }
+            if (shielded) {
+                int strongest = flames[0].strength >= flames[1].strength ? 0 : 1;
+                flames[strongest].shielded = true;
+            }
+            int startAngle = 30 + (int)(120 * uniform(scenarioRng));
+            for (int p = 0; p < policyCount; p++) {
+                std::mt19937 noiseRng(s);
+                results[p].push_back(runScenario(flames, startAngle, dwellLimits[p], noiseRng));
+            }
+        }
+        for (int p = 0; p < policyCount; p++) {
+            summarize(shielded ? "shielded" : "open", policies[p], results[p]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+// Parameter sweep of the flame detector over recorded site traces.
+//
+// Every trace is memory-mapped and parsed once into shared, read-only
+// per-channel columns. The real FlameTriangulation then runs every
+// (parameter set, trace) pair as one task on a work-stealing thread pool:
+// tasks are dealt round-robin to per-worker queues, and a worker whose
+// queue runs dry takes tasks from the far end of the others'. Each task
+// writes only its own result slot, so the workers share no mutable state
+// (the host clock is per thread) and throughput scales with the cores.
+//
+// The grid covers the runtime DetectionSettings, the CFAR multiplier k and
+// the fixed threshold. The compile-time constants (SMOOTHING_WINDOW,
+// DRIFT_MIN_SAMPLES, DRIFT_WARNING_COUNTS, REBASELINE_STEP_COUNTS in
+// FlameTriangulation.h) are compared by building variants:
+//
+//   make build/param_sweep SWEEP_DEFINES="-DSMOOTHING_WINDOW=3" -B
+//
+// Trace format: "A0 A1 A2" raw 10-bit readings per line, as printed by
+// examples/Sensor_Debugging.ino or tools/capture_decode. '#' lines are
+// comments, except for:
+//   # raw capture, <rate> Hz ...   sample rate (written by capture_decode)
+//   # flame <bearing>              a flame is present from here on, at the
+//                                  given bearing in degrees (positive = right)
+//   # flame off                    the flame is gone
+// Traces without flame annotations are scored for false alarms only.
+// Consecutive samples are averaged into 200 Hz frames like AdcSampler's.
+//
+// Output is CSV, one line per parameter set summed over all traces:
+//   noise_k, fixed_threshold (10-bit counts), flames, detected,
+//   latency_mean_ms, latency_max_ms, false_alarms, false_per_hour,
+//   angle_rms (degrees, detected flame frames), drift_warnings
+//
+//   make && build/param_sweep --k 3:9:1 --fixed 50:200:50 site*.txt > sweep.csv
+
+#include "host/Arduino.h"
+#include "../include/FlameTriangulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <math.h>
+#include <mutex>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FRAME_RATE 200.0           // Firmware frames per second
+#define CALIBRATION_FRAMES 20      // Frames averaged for the initial baseline
+#define MONITOR_INTERVAL 5000      // updateCalibrationMonitoring period (ms), as in main.cpp
+#define FALSE_ALARM_GRACE 3000     // Detections this soon after a flame ends are not false alarms (ms)
+#define NO_FLAME INT8_MIN          // Truth column value without a flame
+
+// One trace as parallel columns, one entry per frame
+struct Trace {
+    const char* path;
+    double framePeriod;            // Seconds
+    std::vector<int16_t> right, left, middle;
+    std::vector<int8_t> truth;     // Flame bearing, or NO_FLAME
+    size_t frames() const { return truth.size(); }
+};
+
+struct ParamSet {
+    float noiseMultiplier;
+    int fixedThreshold;            // 10-bit counts
+};
+
+struct Result {
+    unsigned long flames, detected, falseAlarms, warnings;
+    double latencySum, latencyMax;
+    double angleSquares;
+    unsigned long angleFrames;
+    double hours;
+};
+
+// --- Trace loading ---
+
+static const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+static bool startsWith(const char* p, const char* end, const char* prefix) {
+    size_t n = strlen(prefix);
+    return (size_t)(end - p) >= n && memcmp(p, prefix, n) == 0;
+}
+
+// Parses the mapped text in place. Samples are averaged in groups into
+// frames; the group size follows the capture rate (or defaultRate)
+static void parseTrace(const char* p, const char* end, double defaultRate, Trace& trace) {
+    double rate = defaultRate;
+    int group = 0;
+    long sums[3] = { 0, 0, 0 };
+    int inGroup = 0;
+    int8_t bearing = NO_FLAME;
+    while (p < end) {
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if (!eol) eol = end;
+        p = skipSpaces(p, eol);
+        if (p < eol && *p == '#') {
+            const char* q = skipSpaces(p + 1, eol);
+            if (startsWith(q, eol, "raw capture,") && group == 0) {
+                rate = strtod(q + strlen("raw capture,"), NULL);
+            } else if (startsWith(q, eol, "flame")) {
+                q = skipSpaces(q + strlen("flame"), eol);
+                if (startsWith(q, eol, "off")) bearing = NO_FLAME;
+                else bearing = (int8_t)constrain(lround(strtod(q, NULL)), -90L, 90L);
+            }
+        } else if (p < eol) {
+            char* next;
+            long a0 = strtol(p, &next, 10);
+            long a1 = strtol(next, &next, 10);
+            long a2 = strtol(next, &next, 10);
+            if (next <= eol && next > p) {
+                if (group == 0) {
+                    group = std::max(1L, lround(rate / FRAME_RATE));
+                    trace.framePeriod = group / rate;
+                }
+                sums[0] += a2;  // SENSOR1_PIN, right
+                sums[1] += a0;  // SENSOR2_PIN, left
+                sums[2] += a1;  // SENSOR3_PIN, middle
+                if (++inGroup == group) {
+                    // Mean of the group at the firmware's reading width
+                    trace.right.push_back((int16_t)((sums[0] << ADC_OVERSAMPLE_BITS) / group));
+                    trace.left.push_back((int16_t)((sums[1] << ADC_OVERSAMPLE_BITS) / group));
+                    trace.middle.push_back((int16_t)((sums[2] << ADC_OVERSAMPLE_BITS) / group));
+                    trace.truth.push_back(bearing);
+                    sums[0] = sums[1] = sums[2] = 0;
+                    inGroup = 0;
+                }
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+static bool loadTrace(const char* path, double defaultRate, Trace& trace) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    trace.path = path;
+    trace.framePeriod = 1.0 / FRAME_RATE;
+    if (st.st_size > 0) {
+        void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        const char* text = (const char*)data;
+        parseTrace(text, text + st.st_size, defaultRate, trace);
+        munmap(data, st.st_size);
+    }
+    close(fd);
+    return true;
+}
+
+// --- Evaluation ---
+
+static void evaluate(const ParamSet& params, const Trace& trace, Result& result) {
+    memset(&result, 0, sizeof(result));
+    size_t frames = trace.frames();
+    if (frames <= CALIBRATION_FRAMES) return;
+    unsigned long framePeriod = (unsigned long)lround(trace.framePeriod * 1e6);
+
+    hostSetMicros(0);
+    DetectionSettings detection = { params.noiseMultiplier, params.fixedThreshold << ADC_OVERSAMPLE_BITS };
+    FlameTriangulation flameSensor(detection);
+    long cal[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < CALIBRATION_FRAMES; i++) {
+        cal[0] += trace.right[i];
+        cal[1] += trace.left[i];
+        cal[2] += trace.middle[i];
+    }
+    flameSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES, cal[2] / CALIBRATION_FRAMES);
+
+    unsigned long lastMonitor = 0;
+    unsigned long flameStart = 0, flameEnd = 0;
+    bool inFlame = false, flameDetected = false, wasDetected = false, hadFlame = false;
+    bool warned = false;
+    for (size_t i = CALIBRATION_FRAMES; i < frames; i++) {
+        hostAdvanceMicros(framePeriod);
+        unsigned long now = millis();
+        flameSensor.updateReadings(trace.right[i], trace.left[i], trace.middle[i]);
+        bool detected = flameSensor.isFlameDetected();
+        int8_t truth = trace.truth[i];
+
+        if (truth != NO_FLAME && !inFlame) {
+            inFlame = true;
+            flameDetected = false;
+            flameStart = now;
+            result.flames++;
+        } else if (truth == NO_FLAME && inFlame) {
+            inFlame = false;
+            hadFlame = true;
+            flameEnd = now;
+        }
+        if (inFlame) {
+            if (detected && !flameDetected) {
+                flameDetected = true;
+                result.detected++;
+                double latency = now - flameStart;
+                result.latencySum += latency;
+                result.latencyMax = std::max(result.latencyMax, latency);
+            }
+            if (detected) {
+                double error = flameSensor.getFlameAngle() - truth;
+                result.angleSquares += error * error;
+                result.angleFrames++;
+            }
+        } else if (detected && !wasDetected && !(hadFlame && now - flameEnd < FALSE_ALARM_GRACE)) {
+            result.falseAlarms++;
+        }
+        wasDetected = detected;
+
+        if (now - lastMonitor >= MONITOR_INTERVAL) {
+            lastMonitor = now;
+            flameSensor.updateCalibrationMonitoring();
+            if (flameSensor.calibrationNeeded && !warned) result.warnings++;
+            warned = flameSensor.calibrationNeeded;
+        }
+    }
+    result.hours = (frames - CALIBRATION_FRAMES) * trace.framePeriod / 3600.0;
+}
+
+static void accumulate(Result& total, const Result& r) {
+    total.flames += r.flames;
+    total.detected += r.detected;
+    total.falseAlarms += r.falseAlarms;
+    total.warnings += r.warnings;
+    total.latencySum += r.latencySum;
+    total.latencyMax = std::max(total.latencyMax, r.latencyMax);
+    total.angleSquares += r.angleSquares;
+    total.angleFrames += r.angleFrames;
+    total.hours += r.hours;
+}
+
+// --- Work-stealing pool ---
+
+// Runs task(0..count-1) on the given number of threads. All tasks exist
+// up front, so a worker is done once its own queue and every other queue
+// are empty.
+template <typename Task>
+static void runTasks(size_t count, unsigned threads, const Task& task) {
+    struct Queue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+    std::vector<Queue> queues(threads);
+    for (size_t i = 0; i < count; i++) queues[i % threads].tasks.push_back(i);
+
+    auto take = [&](unsigned self, size_t& index) {
+        {
+            // Own queue from the back...
+            std::lock_guard<std::mutex> guard(queues[self].lock);
+            if (!queues[self].tasks.empty()) {
+                index = queues[self].tasks.back();
+                queues[self].tasks.pop_back();
+                return true;
+            }
+        }
+        // ...others' from the front
+        for (unsigned k = 1; k < threads; k++) {
+            Queue& victim = queues[(self + k) % threads];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            size_t index;
+            while (take(t, index)) task(index);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+// --- Command line ---
+
+// "from:to:step" or a single value
+static bool parseRange(const char* text, std::vector<double>& values) {
+    double from, to, step;
+    int n = sscanf(text, "%lf:%lf:%lf", &from, &to, &step);
+    if (n == 1) {
+        values.assign(1, from);
+        return true;
+    }
+    if (n != 3 || step <= 0 || to < from) return false;
+    values.clear();
+    for (double v = from; v <= to + step * 1e-6; v += step) values.push_back(v);
+    return true;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [--k from:to:step] [--fixed from:to:step] [--threads N] [--rate HZ] trace...\n"
+            "  --k        CFAR noise multipliers (default 3:9:1)\n"
+            "  --fixed    fixed thresholds, 10-bit counts (default 50:200:50)\n"
+            "  --threads  worker threads (default: all cores)\n"
+            "  --rate     sample rate of traces without a capture header (default 200 Hz)\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    std::vector<double> multipliers, thresholds;
+    parseRange("3:9:1", multipliers);
+    parseRange("50:200:50", thresholds);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double defaultRate = FRAME_RATE;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--k") && hasValue) {
+            if (!parseRange(argv[++i], multipliers)) return usage(argv[0]), 1;
+        } else if (!strcmp(argv[i], "--fixed") && hasValue) {
+            if (!parseRange(argv[++i], thresholds)) return usage(argv[0]), 1;
+        } else if (!strcmp(argv[i], "--threads") && hasValue) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--rate") && hasValue) {
+            defaultRate = atof(argv[++i]);
+            if (defaultRate <= 0) return usage(argv[0]), 1;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Trace> traces(paths.size());
+    size_t totalFrames = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!loadTrace(paths[i], defaultRate, traces[i])) {
+            fprintf(stderr, "cannot read %s\n", paths[i]);
+            return 1;
+        }
+        totalFrames += traces[i].frames();
+    }
+
+    std::vector<ParamSet> grid;
+    for (double k : multipliers) {
+        for (double fixed : thresholds) grid.push_back({ (float)k, (int)lround(fixed) });
+    }
+
+    // Tasks are (parameter set, trace) pairs, longest traces first so the
+    // stragglers at the end of the run are short ones
+    std::vector<size_t> order(traces.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return traces[a].frames() > traces[b].frames(); });
+    std::vector<Result> results(grid.size() * traces.size());
+    auto start = std::chrono::steady_clock::now();
+    runTasks(results.size(), threads, [&](size_t index) {
+        size_t trace = order[index / grid.size()];
+        size_t params = index % grid.size();
+        evaluate(grid[params], traces[trace], results[params * traces.size() + trace]);
+    });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("# %zu traces, %zu frames, %zu parameter sets, %u threads\n", traces.size(), totalFrames,
+           grid.size(), threads);
+    printf("# SMOOTHING_WINDOW %d, DRIFT_MIN_SAMPLES %d, DRIFT_WARNING_COUNTS %d, REBASELINE_STEP_COUNTS %d\n",
+           SMOOTHING_WINDOW, DRIFT_MIN_SAMPLES, DRIFT_WARNING_COUNTS, REBASELINE_STEP_COUNTS);
+    printf("noise_k,fixed_threshold,flames,detected,latency_mean_ms,latency_max_ms,"
+           "false_alarms,false_per_hour,angle_rms,drift_warnings\n");
+    for (size_t p = 0; p < grid.size(); p++) {
+        Result total;
+        memset(&total, 0, sizeof(total));
+        for (size_t t = 0; t < traces.size(); t++) accumulate(total, results[p * traces.size() + t]);
+        printf("%.2f,%d,%lu,%lu,%.0f,%.0f,%lu,%.2f,%.2f,%lu\n", grid[p].noiseMultiplier, grid[p].fixedThreshold,
+               total.flames, total.detected, total.detected ? total.latencySum / total.detected : 0.0,
+               total.latencyMax, total.falseAlarms, total.hours > 0 ? total.falseAlarms / total.hours : 0.0,
+               total.angleFrames ? sqrt(total.angleSquares / total.angleFrames) : 0.0, total.warnings);
+    }
+    fprintf(stderr, "%.2f s wall, %.1f M frames/s\n", wall,
+            wall > 0 ? totalFrames * (double)grid.size() / wall / 1e6 : 0.0);
+    return 0;
+}
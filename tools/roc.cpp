@@ -0,0 +1,102 @@
+// ROC comparison of the fixed-threshold and CFAR flame detectors.
+//
+// Synthetic 12-bit frames are generated for two environments: a noisy
+// sunlit bay and a quiet dark store. Each trial calibrates a fresh
+// FlameTriangulation, lets it learn the noise for a warm-up period and
+// then runs a one-second window with or without a weak flame. A window
+// counts as a detection if any frame reports a flame.
+//
+// Output is CSV: detector, parameter, environment, Pd, Pfa. The fixed
+// detector sweeps its threshold; CFAR sweeps the noise multiplier k.
+//
+//   make && build/roc > roc.csv
+
+#include "host/Arduino.h"
+#include "../include/FlameTriangulation.h"
+#include "sensor_model.h"
+
+#include <random>
+
+#define FRAME_MICROS 5000      // 200 Hz frames
+#define CALIBRATION_FRAMES 20
+#define WARMUP_FRAMES 400
+#define WINDOW_FRAMES 200
+#define TRIALS 300
+
+struct Environment {
+    const char* name;
+    float ambient;       // 10-bit counts
+    float noise;         // Frame noise sigma, 10-bit counts
+    float drift;         // Slow ambient wander amplitude, 10-bit counts
+    float minFlame;      // Weakest/strongest flame response, 10-bit counts
+    float maxFlame;
+};
+
+static const Environment environments[] = {
+    { "sunlit", 650, 10.0, 8.0, 40, 200 },
+    { "dark", 960, 1.5, 0.5, 10, 80 },
+};
+
+// Runs one trial; returns true if any frame in the test window detects
+static bool runTrial(const Environment& env, bool flamePresent, float multiplier, int fixedThreshold,
+                     std::mt19937& rng) {
+    std::normal_distribution<float> noise(0.0, env.noise);
+    std::uniform_real_distribution<float> uniform(0.0, 1.0);
+    const int scale = 1 << ADC_OVERSAMPLE_BITS;
+    float phase = uniform(rng) * 2 * PI;
+    float strength = env.minFlame + uniform(rng) * (env.maxFlame - env.minFlame);
+    float gains[3];
+    sensorGains(-30.0 + 60.0 * uniform(rng), 50.0, gains);
+
+    DetectionSettings detection = { multiplier, fixedThreshold };
+    FlameTriangulation flameSensor(detection);
+
+    long cal[3] = { 0, 0, 0 };
+    int frames = CALIBRATION_FRAMES + WARMUP_FRAMES + WINDOW_FRAMES;
+    for (int f = 0; f < frames; f++) {
+        float ambient = env.ambient + env.drift * sin(phase + f * 0.01);
+        bool flame = flamePresent && f >= CALIBRATION_FRAMES + WARMUP_FRAMES;
+        int r[3];
+        for (int c = 0; c < 3; c++) {
+            float value = ambient + noise(rng) - (flame ? strength * gains[c] : 0.0);
+            r[c] = constrain((int)lround(value * scale), 0, ADC_SAMPLE_MAX);
+        }
+        hostAdvanceMicros(FRAME_MICROS);
+        if (f < CALIBRATION_FRAMES) {
+            for (int c = 0; c < 3; c++) cal[c] += r[c];
+            if (f == CALIBRATION_FRAMES - 1) {
+                flameSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES,
+                                      cal[2] / CALIBRATION_FRAMES);
+            }
+            continue;
+        }
+        flameSensor.updateReadings(r[0], r[1], r[2]);
+        if (f >= CALIBRATION_FRAMES + WARMUP_FRAMES && flameSensor.isFlameDetected()) return true;
+    }
+    return false;
+}
+
+static void evaluate(const char* detector, float parameter, float multiplier, int fixedThreshold) {
+    for (const Environment& env : environments) {
+        std::mt19937 rng(12345); // Same scenarios for every setting
+        int hits = 0, falseAlarms = 0;
+        for (int t = 0; t < TRIALS; t++) {
+            if (runTrial(env, true, multiplier, fixedThreshold, rng)) hits++;
+            if (runTrial(env, false, multiplier, fixedThreshold, rng)) falseAlarms++;
+        }
+        printf("%s,%.1f,%s,%.3f,%.3f\n", detector, parameter, env.name,
+               (float)hits / TRIALS, (float)falseAlarms / TRIALS);
+    }
+}
+
+int main() {
+    printf("detector,parameter,environment,pd,pfa\n");
+    const int scale = 1 << ADC_OVERSAMPLE_BITS;
+    for (int threshold = 10; threshold <= 200; threshold += 10) {
+        evaluate("fixed", threshold, 0.0, threshold * scale);
+    }
+    for (float k = 3.0; k <= 12.0; k += 0.5) {
+        evaluate("cfar", k, k, 100 * scale);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "sensor_model.h"
+#include "../include/AdcSampler.h"
+
+#include <math.h>
+
+static const float SENSOR_X[3] = { 5.0f, -5.0f, 0.0f };
+static const float HALF_ANGLE_DEG = 30.0f;
+static const float DEG = 3.14159265f / 180.0f;
+
+// Cosine lobe reaching zero at the cone edge
+static float lobeGain(float dx, float dy) {
+    float offAxis = atan2f(dx, dy) / DEG;
+    return (dy > 0 && fabsf(offAxis) < HALF_ANGLE_DEG) ? cosf(offAxis * 90.0f / HALF_ANGLE_DEG * DEG) : 0.0f;
+}
+
+void sensorGains(float bearingDeg, float distanceCm, float gains[3]) {
+    float fx = distanceCm * sinf(bearingDeg * DEG);
+    float fy = distanceCm * cosf(bearingDeg * DEG);
+    for (int c = 0; c < 3; c++) {
+        gains[c] = lobeGain(fx - SENSOR_X[c], fy);
+    }
+}
+
+void sensorResponse(float x, float y, float power, float response[3]) {
+    for (int c = 0; c < 3; c++) {
+        float dx = x - SENSOR_X[c];
+        float rangeSquared = dx * dx + y * y;
+        if (rangeSquared < 1.0f) rangeSquared = 1.0f;
+        response[c] = power * lobeGain(dx, y) * SENSOR_REFERENCE_DISTANCE * SENSOR_REFERENCE_DISTANCE / rangeSquared;
+    }
+}
+
+void sensorFrame(const float response[3], float ambient, float noise, std::mt19937& rng,
+                 int readings[3]) {
+    std::normal_distribution<float> sampleNoise(0.0f, noise);
+    for (int c = 0; c < 3; c++) {
+        long sum = 0;
+        for (int i = 0; i < ADC_OVERSAMPLE_COUNT; i++) {
+            long value = lroundf(ambient - response[c] + sampleNoise(rng));
+            sum += constrain(value, 0L, 1023L);
+        }
+        readings[c] = sum >> ADC_OVERSAMPLE_BITS;
+    }
+}
@@ -0,0 +1,30 @@
+// Flame sensor response model shared by the host simulations.
+//
+// Geometry follows FlameTriangulation.h: three forward-facing sensors at
+// x = +5 cm (right), -5 cm (left) and 0 cm (middle), each with a 60 degree
+// detection cone (30 degree half angle).
+#ifndef SENSOR_MODEL_H
+#define SENSOR_MODEL_H
+
+#include <random>
+
+// Relative response (0-1) of each sensor, in firmware order (right, left,
+// middle), to a point flame at the given bearing relative to the sensor
+// axis (positive = right) and distance in cm
+void sensorGains(float bearingDeg, float distanceCm, float gains[3]);
+
+// Response of each sensor, in 10-bit counts below ambient, to a point
+// flame at (x, y) cm in head coordinates (x to the right of the middle
+// sensor, y forward). power is the response of a sensor looking straight
+// at the flame from SENSOR_REFERENCE_DISTANCE; it falls off with the
+// inverse square of each sensor's own range.
+#define SENSOR_REFERENCE_DISTANCE 100.0f
+void sensorResponse(float x, float y, float power, float response[3]);
+
+// One oversampled frame as AdcSampler produces it: 4^ADC_OVERSAMPLE_BITS
+// 10-bit conversions per channel, each with Gaussian noise of the given
+// sigma and quantized, summed and shifted right by ADC_OVERSAMPLE_BITS
+void sensorFrame(const float response[3], float ambient, float noise, std::mt19937& rng,
+                 int readings[3]);
+
+#endif // SENSOR_MODEL_H
@@ -0,0 +1,149 @@
+// Angle jitter on flickering flames, with and without skew correction.
+//
+// Simulates the sampler at conversion level: the ADC interrupt converts
+// the channels in turn, one conversion every 13 ADC clocks plus the time
+// from the end of a conversion to the start of the next (interrupt entry
+// and handler, occasionally held up by the timer, UART and I2C
+// interrupts). ADC_OVERSAMPLE_COUNT passes are summed into a frame and
+// stamped as AdcSampler stamps it. A point flame at a fixed bearing
+// flickers: its output is modulated by FLICKER_DEPTH at one frequency.
+// The real FlameTriangulation estimates the angle from the triples as
+// read and from SampleAligner's, the loop reading one frame in
+// LOOP_FRAMES, and the tool reports the standard
+// deviation of the angle per flicker frequency, averaged in quadrature
+// over the bearings.
+//
+//   make && build/skew_jitter
+
+#include "host/Arduino.h"
+#include "../include/FlameTriangulation.h"
+#include "../include/SampleAligner.h"
+#include "sensor_model.h"
+
+#include <random>
+
+#define CONVERSION_MICROS (13.0 * (1 << ADC_PRESCALER_BITS) / 16)
+#define LATENCY_MICROS 6.0         // Interrupt entry and handler up to the next start
+#define BLOCKED_CHANCE 0.05        // Share of conversions held up by another interrupt
+#define BLOCKED_MICROS 10.0        // For up to this long
+#define NOISE 1.0f                 // Per-conversion sigma, 10-bit counts
+#define AMBIENT 800.0f             // 10-bit counts
+#define DISTANCE 60.0f             // cm
+#define POWER 150.0f               // Response at SENSOR_REFERENCE_DISTANCE, 10-bit counts
+#define FLICKER_DEPTH 0.5f         // Peak modulation of the flame's output
+#define CALIBRATION_FRAMES 20
+#define SETTLE_FRAMES 200          // Noise statistics and smoothing settle
+#define MEASURE_FRAMES 2000
+#define LOOP_FRAMES 10             // The main loop reads about one frame in 10
+
+struct Jitter {
+    double raw;
+    double aligned;
+};
+
+// Converts one frame of round-robin passes starting at time t (us); the
+// flame's response to each conversion is taken at its sample instant
+static void convertFrame(double& t, bool lit, float bearing, float flicker, float phase, std::mt19937& rng,
+                         SampleTriple& triple) {
+    std::normal_distribution<float> noise(0.0f, NOISE);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    float gains[3];
+    sensorGains(bearing, DISTANCE, gains);
+    float power = lit ? POWER * SENSOR_REFERENCE_DISTANCE * SENSOR_REFERENCE_DISTANCE / (DISTANCE * DISTANCE) : 0;
+    long sums[3] = { 0, 0, 0 };
+    double firstStart[3] = { 0, 0, 0 };
+    for (int pass = 0; pass < ADC_OVERSAMPLE_COUNT; pass++) {
+        for (int ch = 0; ch < 3; ch++) {
+            if (pass == 0) firstStart[ch] = t;
+            if (pass == ADC_OVERSAMPLE_COUNT - 1) {
+                triple.stamp[ch] = (uint16_t)(unsigned long)(firstStart[ch] + (t - firstStart[ch]) / 2);
+            }
+            // Sample and hold 1.5 ADC clocks after the start
+            double sampleTime = t + 1.5 * (1 << ADC_PRESCALER_BITS) / 16;
+            float output = 1.0f + FLICKER_DEPTH * sinf(2 * PI * flicker * sampleTime * 1e-6 + phase);
+            float value = AMBIENT - power * output * gains[ch] + noise(rng);
+            sums[ch] += constrain((int)lroundf(value), 0, 1023);
+            t += CONVERSION_MICROS + LATENCY_MICROS;
+            if (uniform(rng) < BLOCKED_CHANCE) t += BLOCKED_MICROS * uniform(rng);
+        }
+    }
+    for (int ch = 0; ch < 3; ch++) triple.reading[ch] = sums[ch] >> ADC_OVERSAMPLE_BITS;
+}
+
+// Standard deviation of the angle at one bearing and flicker frequency
+static Jitter measure(float bearing, float flicker, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    float phase = uniform(rng) * 2 * PI;
+    FlameTriangulation rawSensor(DEFAULT_DETECTION_SETTINGS);
+    FlameTriangulation alignedSensor(DEFAULT_DETECTION_SETTINGS);
+    SampleAligner aligner;
+    SampleTriple previous = {};
+    double t = 0;
+    long cal[3] = { 0, 0, 0 };
+    double sums[2] = { 0, 0 }, squares[2] = { 0, 0 };
+    long count[2] = { 0, 0 };
+
+    // Flame-free calibration and settling, then the flame
+    for (int n = 0; n < LOOP_FRAMES * (CALIBRATION_FRAMES + 2 * SETTLE_FRAMES + MEASURE_FRAMES); n++) {
+        // Frames read by the loop; as AdcSampler keeps it, each carries
+        // the one converted before it
+        int f = n / LOOP_FRAMES;
+        bool lit = f >= CALIBRATION_FRAMES + SETTLE_FRAMES;
+        SampleTriple triple;
+        convertFrame(t, lit, bearing, flicker, phase, rng, triple);
+        for (int ch = 0; ch < 3; ch++) {
+            triple.previous[ch] = previous.reading[ch];
+            triple.previousStamp[ch] = previous.stamp[ch];
+        }
+        triple.hasPrevious = n > 0;
+        previous = triple;
+        if (n % LOOP_FRAMES) continue;
+        hostSetMicros((unsigned long)t);
+        int aligned[3];
+        aligner.align(triple, aligned[0], aligned[1], aligned[2]);
+        if (f < CALIBRATION_FRAMES) {
+            for (int ch = 0; ch < 3; ch++) cal[ch] += triple.reading[ch];
+            if (f == CALIBRATION_FRAMES - 1) {
+                rawSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES, cal[2] / CALIBRATION_FRAMES);
+                alignedSensor.calibrate(cal[0] / CALIBRATION_FRAMES, cal[1] / CALIBRATION_FRAMES, cal[2] / CALIBRATION_FRAMES);
+            }
+            continue;
+        }
+        rawSensor.updateReadings(triple.reading[0], triple.reading[1], triple.reading[2]);
+        alignedSensor.updateReadings(aligned[0], aligned[1], aligned[2]);
+        if (f < CALIBRATION_FRAMES + 2 * SETTLE_FRAMES) continue;
+        FlameTriangulation* sensors[2] = { &rawSensor, &alignedSensor };
+        for (int i = 0; i < 2; i++) {
+            if (!sensors[i]->isFlameDetected()) continue;
+            double angle = sensors[i]->getFlameAngle();
+            sums[i] += angle;
+            squares[i] += angle * angle;
+            count[i]++;
+        }
+    }
+    Jitter jitter;
+    double* results[2] = { &jitter.raw, &jitter.aligned };
+    for (int i = 0; i < 2; i++) {
+        double mean = count[i] ? sums[i] / count[i] : 0;
+        *results[i] = count[i] ? sqrt(std::max(squares[i] / count[i] - mean * mean, 0.0)) : NAN;
+    }
+    return jitter;
+}
+
+int main() {
+    const float bearings[] = { -20, -10, -5, 5, 10, 20 };
+    const float flickers[] = { 0, 5, 10, 15, 25, 40 };
+    printf("flicker Hz  raw deg  aligned deg\n");
+    for (float flicker : flickers) {
+        std::mt19937 rng(7);  // Same conversion noise for every frequency
+        double raw = 0, aligned = 0;
+        for (float bearing : bearings) {
+            Jitter jitter = measure(bearing, flicker, rng);
+            raw += jitter.raw * jitter.raw;
+            aligned += jitter.aligned * jitter.aligned;
+        }
+        int n = sizeof(bearings) / sizeof(bearings[0]);
+        printf("%10.0f %8.3f %12.3f\n", flicker, sqrt(raw / n), sqrt(aligned / n));
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+// Whole-system closed-loop simulation.
+//
+// Links main.cpp and the firmware modules unchanged, with host stand-ins
+// for the ADC sampler, LCD, DHT, EEPROM, tone and Servo (tools/host/), and
+// runs setup() and loop() against a plant:
+//   - the head slews toward the commanded servo angle at a limited rate
+//     and the sensors turn with it
+//   - one flame at a random bearing, distance and size lights after the
+//     boot calibration; it weakens while the water jet is on it, regrows
+//     otherwise, and its embers keep glowing after it is out
+//   - sensor frames come from the shared sensor model (inverse-square
+//     falloff, per-conversion noise, oversampling as AdcSampler does it)
+//
+// Each scenario runs in its own forked process (the firmware's globals
+// are set up once per process), as many at a time as there are CPUs.
+// Reports time to detect, time to extinguish, relay time with the jet on
+// the flame, total water and water after the flame is out, and false
+// alarms before ignition.
+//
+//   make && build/system_sim [scenarios] [--csv]
+//   build/system_sim --serial N      run scenario N with the firmware's
+//                                    serial output on stdout
+
+#include "host/Arduino.h"
+#include "host/HostPeripherals.h"
+#include "../include/FlameTriangulation.h"
+#include "../include/ServoControl.h"
+#include "../include/PumpControl.h"
+#include "../include/EventBus.h"
+#include "sensor_model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#define SIM_LIMIT_MS 120000UL     // Give up on a scenario after this much simulated time
+#define TAIL_MS 10000UL           // Simulated after the flame is out (water still used)
+#define IGNITION_MIN_MS 5000UL    // After the boot-time fine calibration
+#define IGNITION_SPAN_MS 5000UL
+#define BEARING_MIN 35.0f         // Flames inside the scan range, servo degrees
+#define BEARING_MAX 145.0f
+#define DISTANCE_MIN 40.0f        // cm
+#define DISTANCE_MAX 150.0f
+#define POWER_MIN 60.0f           // Response at SENSOR_REFERENCE_DISTANCE, 10-bit counts
+#define POWER_MAX 250.0f
+#define AMBIENT_MIN 700.0f        // 10-bit counts
+#define AMBIENT_MAX 950.0f
+#define NOISE_MIN 1.0f            // Per-conversion sigma, 10-bit counts
+#define NOISE_MAX 3.0f
+#define SERVO_SLEW_DEG_PER_MS 0.4f
+#define JET_HALF_WIDTH 6.0f       // Degrees around the heading that the water reaches
+#define SUPPRESS_RATE 0.05f       // Counts per ms of water on the flame
+#define REGROW_RATE 0.002f        // Counts per ms without water
+#define OUT_LEVEL 20.0f           // Flame is out below this strength
+#define EMBER_DECAY_MS 20000.0f   // Embers keep glowing, fading with this time constant
+#define BUTTON_PIN_MASK (1 << 2)  // CALIBRATION_BUTTON on PIND, active low
+
+// Firmware entry points and globals from main.cpp
+void setup();
+void loop();
+extern ServoControl servoControl;
+extern PumpControl pumpControl;
+
+struct Scenario {
+    float bearing;
+    float distance;
+    float power;
+    float ambient;
+    float noise;
+    unsigned long ignition;
+};
+
+struct Result {
+    bool detected;
+    bool extinguished;
+    unsigned long detectMs;       // Ignition to first EVENT_FLAME_START
+    unsigned long extinguishMs;   // Ignition to flame out
+    unsigned long onTargetMs;     // Relay closed with the jet on the burning flame
+    unsigned long waterMs;        // Relay closed in total
+    unsigned long wastedMs;       // Relay closed after the flame was out
+    unsigned int falseAlarms;     // EVENT_FLAME_START before ignition
+    unsigned long simulatedMs;
+};
+
+// Plant state for the scenario running in this process
+static Scenario scenario;
+static Result result;
+static std::mt19937 rng;
+static float head = 90.0f;
+static float strength = 0.0f;
+static bool burning = false;
+static unsigned long outTime = 0;
+static unsigned long plantTime = 0;
+
+static Scenario makeScenario(int index) {
+    std::mt19937 scenarioRng(index);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    Scenario s;
+    s.bearing = BEARING_MIN + (BEARING_MAX - BEARING_MIN) * uniform(scenarioRng);
+    s.distance = DISTANCE_MIN + (DISTANCE_MAX - DISTANCE_MIN) * uniform(scenarioRng);
+    s.power = POWER_MIN + (POWER_MAX - POWER_MIN) * uniform(scenarioRng);
+    s.ambient = AMBIENT_MIN + (AMBIENT_MAX - AMBIENT_MIN) * uniform(scenarioRng);
+    s.noise = NOISE_MIN + (NOISE_MAX - NOISE_MIN) * uniform(scenarioRng);
+    s.ignition = IGNITION_MIN_MS + (unsigned long)(IGNITION_SPAN_MS * uniform(scenarioRng));
+    return s;
+}
+
+// Sensor frame for the current head position
+static void frameSource(int readings[3]) {
+    float response[3] = { 0, 0, 0 };
+    float emission = 0;
+    if (burning) emission = strength;
+    else if (outTime) emission = OUT_LEVEL * expf(-(float)(plantTime - outTime) / EMBER_DECAY_MS);
+    if (emission > 0) {
+        // Positive relative bearing = to the right of the head
+        float relative = (head - scenario.bearing) * (float)PI / 180.0f;
+        sensorResponse(scenario.distance * sinf(relative), scenario.distance * cosf(relative),
+                       emission, response);
+    }
+    sensorFrame(response, scenario.ambient, scenario.noise, rng, readings);
+}
+
+static void handleEvent(const Event& event, void* context) {
+    if (event.type != EVENT_FLAME_START) return;
+    unsigned long now = millis();
+    if (now < scenario.ignition) {
+        result.falseAlarms++;
+    } else if (!result.detected) {
+        result.detected = true;
+        result.detectMs = now - scenario.ignition;
+    }
+}
+
+// Advance the plant in 1 ms steps to the firmware's current time
+static void advancePlant(unsigned long now) {
+    for (; plantTime < now; plantTime++) {
+        float command = servoControl.getCurrentAngle();
+        head += constrain(command - head, -SERVO_SLEW_DEG_PER_MS, SERVO_SLEW_DEG_PER_MS);
+
+        if (plantTime == scenario.ignition) {
+            burning = true;
+            strength = scenario.power;
+        }
+        bool spraying = pumpControl.isPumpActive();
+        bool onFlame = fabsf(head - scenario.bearing) <= JET_HALF_WIDTH;
+        if (spraying) {
+            result.waterMs++;
+            if (burning && onFlame) result.onTargetMs++;
+            if (outTime) result.wastedMs++;
+        }
+        if (!burning) continue;
+        if (spraying && onFlame) strength -= SUPPRESS_RATE;
+        else if (strength < scenario.power) strength += REGROW_RATE;
+        if (strength < OUT_LEVEL) {
+            burning = false;
+            outTime = plantTime;
+            result.extinguished = true;
+            result.extinguishMs = plantTime - scenario.ignition;
+        }
+    }
+}
+
+static Result runScenario(int index) {
+    scenario = makeScenario(index);
+    rng.seed(index);
+    memset(&result, 0, sizeof(result));
+    hostSetMicros(0);
+    hostSetFrameSource(frameSource);
+    PIND |= BUTTON_PIN_MASK;
+
+    setup();
+    eventBus.subscribe(EVENT_MASK(EVENT_FLAME_START), handleEvent, nullptr);
+    head = servoControl.getCurrentAngle();
+    plantTime = millis();
+
+    unsigned long end = SIM_LIMIT_MS;
+    while (plantTime < end) {
+        // Calibration button released; on the host, FastPin::toggle()
+        // writes to the input register, so restore it every pass
+        PIND |= BUTTON_PIN_MASK;
+        loop();
+        advancePlant(millis());
+        if (result.extinguished && end == SIM_LIMIT_MS) end = outTime + TAIL_MS;
+    }
+    result.simulatedMs = plantTime;
+    return result;
+}
+
+// Runs every scenario in a forked child, up to `workers` at a time
+static std::vector<Result> runAll(int count, int workers) {
+    struct Child {
+        pid_t pid;
+        int fd;
+        int index;
+    };
+    std::vector<Result> results(count);
+    std::vector<Child> running;
+    int next = 0;
+    fflush(stdout);
+    while (next < count || !running.empty()) {
+        while (next < count && (int)running.size() < workers) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                perror("pipe");
+                exit(1);
+            }
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                Result r = runScenario(next);
+                ssize_t written = write(fds[1], &r, sizeof(r));
+                _exit(written == sizeof(r) ? 0 : 1);
+            }
+            close(fds[1]);
+            running.push_back({ pid, fds[0], next++ });
+        }
+        Child child = running.front();
+        running.erase(running.begin());
+        Result r;
+        if (read(child.fd, &r, sizeof(r)) != sizeof(r)) {
+            fprintf(stderr, "scenario %d failed\n", child.index);
+            memset(&r, 0, sizeof(r));
+        }
+        close(child.fd);
+        waitpid(child.pid, nullptr, 0);
+        results[child.index] = r;
+    }
+    return results;
+}
+
+static double percentile(std::vector<unsigned long> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(p * (values.size() - 1))] / 1000.0;
+}
+
+static void summarize(const std::vector<Result>& results, double wallSeconds) {
+    std::vector<unsigned long> detect, extinguish;
+    double onTarget = 0, water = 0, wasted = 0, simulated = 0;
+    unsigned int falseAlarms = 0;
+    for (const Result& r : results) {
+        simulated += r.simulatedMs / 1000.0;
+        falseAlarms += r.falseAlarms;
+        if (r.detected) detect.push_back(r.detectMs);
+        if (!r.extinguished) continue;
+        extinguish.push_back(r.extinguishMs);
+        onTarget += r.onTargetMs;
+        water += r.waterMs;
+        wasted += r.wastedMs;
+    }
+    size_t n = results.size(), out = extinguish.size();
+    printf("scenarios %zu: detected %zu, extinguished %zu, false alarms %u\n",
+           n, detect.size(), out, falseAlarms);
+    printf("time to detect      p50 %6.2fs  p95 %6.2fs  max %6.2fs\n",
+           percentile(detect, 0.5), percentile(detect, 0.95), percentile(detect, 1.0));
+    printf("time to extinguish  p50 %6.2fs  p95 %6.2fs  max %6.2fs\n",
+           percentile(extinguish, 0.5), percentile(extinguish, 0.95), percentile(extinguish, 1.0));
+    if (out) {
+        printf("water per fire      %6.2fs relay, %4.1f%% on target, %5.2fs after out\n",
+               water / out / 1000.0, 100.0 * onTarget / water, wasted / out / 1000.0);
+    }
+    printf("simulated %.0fs in %.1fs wall (%.0fx real time)\n",
+           simulated, wallSeconds, simulated / wallSeconds);
+}
+
+int main(int argc, char** argv) {
+    int count = 1000;
+    bool csv = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc) {
+            hostSerialEnable(true);
+            Result r = runScenario(atoi(argv[++i]));
+            printf("\ndetected %d after %lu ms, extinguished %d after %lu ms, water %lu ms, false alarms %u\n",
+                   r.detected, r.detectMs, r.extinguished, r.extinguishMs, r.waterMs, r.falseAlarms);
+            return 0;
+        } else {
+            count = atoi(argv[i]);
+        }
+    }
+
+    int workers = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Result> results = runAll(count, workers);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (csv) {
+        printf("scenario,bearing,distance_cm,power,detected,detect_ms,extinguished,extinguish_ms,"
+               "on_target_ms,water_ms,wasted_ms,false_alarms\n");
+        for (int i = 0; i < count; i++) {
+            Scenario s = makeScenario(i);
+            const Result& r = results[i];
+            printf("%d,%.1f,%.0f,%.0f,%d,%lu,%d,%lu,%lu,%lu,%lu,%u\n", i, s.bearing, s.distance, s.power,
+                   r.detected, r.detectMs, r.extinguished, r.extinguishMs, r.onTargetMs, r.waterMs,
+                   r.wastedMs, r.falseAlarms);
+        }
+        return 0;
+    }
+    summarize(results, wall);
+    return 0;
+}
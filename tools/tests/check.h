@@ -0,0 +1,38 @@
+// Assertions for the host unit tests (make -C tools test). A failed check
+// prints its location and values and the test exits non-zero.
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(condition)                                                             \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            checkFailures++;                                                         \
+        }                                                                            \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual)                                                \
+    do {                                                                             \
+        long expected_ = (long)(expected), actual_ = (long)(actual);                 \
+        if (expected_ != actual_) {                                                  \
+            fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__,  \
+                    #actual, actual_, expected_);                                    \
+            checkFailures++;                                                         \
+        }                                                                            \
+    } while (0)
+
+// Exit status for main()
+static int checkResult(const char* name) {
+    if (checkFailures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, checkFailures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif // CHECK_H
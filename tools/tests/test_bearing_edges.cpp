@@ -0,0 +1,39 @@
+// FlameTriangulation::leastSquaresBearing at the edges of the cones: a
+// flame seen by the left or the right sensor alone matches a run of
+// identical table entries, and must read the same distance off centre
+// on either side.
+
+#include "../host/Arduino.h"
+#include "../../include/FlameTriangulation.h"
+#include "check.h"
+
+#define FRAME_MICROS 5000L
+#define AMBIENT 3000
+#define FLAME 800                  // Drop on the one sensor that sees it
+
+// Bearing after a flame is held on one channel (firmware order: right,
+// left, middle)
+static float bearingSeenBy(uint8_t channel) {
+    static DetectionSettings settings = DEFAULT_DETECTION_SETTINGS;
+    FlameTriangulation flameSensor(settings);
+    hostSetMicros(0);
+    flameSensor.calibrate(AMBIENT, AMBIENT, AMBIENT);
+    for (int f = 0; f < 200; f++) {
+        hostAdvanceMicros(FRAME_MICROS);
+        int r[3] = { AMBIENT, AMBIENT, AMBIENT };
+        if (f >= 100) r[channel] -= FLAME;
+        flameSensor.updateReadings(r[0], r[1], r[2]);
+    }
+    CHECK(flameSensor.isFlameDetected());
+    return flameSensor.getFlameAngle();
+}
+
+int main() {
+    float right = bearingSeenBy(0);
+    float left = bearingSeenBy(1);
+    printf("right sensor alone %.1f deg, left sensor alone %.1f deg\n", right, left);
+    CHECK(right > 28.0f);
+    CHECK(left < -28.0f);
+    CHECK(fabsf(right + left) < 0.01f);
+    return checkResult("bearing_edges");
+}
@@ -0,0 +1,63 @@
+// CFAR noise statistics (FlameTriangulation::updateNoiseStats): the
+// thresholds follow the noise after an ambient step, and censoring does
+// not bias sigma low at small multipliers.
+
+#include "../host/Arduino.h"
+#include "../../include/FlameTriangulation.h"
+#include "check.h"
+
+#include <random>
+
+#define FRAME_MICROS 5000L
+#define AMBIENT 3000
+
+// Feeds frames of Gaussian noise around level; returns channel 0's
+// threshold at the end
+static int run(FlameTriangulation& flameSensor, std::mt19937& rng, int level, float sigma, long frames) {
+    std::normal_distribution<float> noise(0.0f, sigma);
+    for (long f = 0; f < frames; f++) {
+        hostAdvanceMicros(FRAME_MICROS);
+        int r[3];
+        for (int c = 0; c < 3; c++) r[c] = constrain(level + (int)lroundf(noise(rng)), 0, ADC_SAMPLE_MAX);
+        flameSensor.updateReadings(r[0], r[1], r[2]);
+    }
+    return flameSensor.getDetectionThreshold(0);
+}
+
+static void testAmbientStep() {
+    // Noisy, then a lamp switches on: the readings step up by 25 counts
+    // (10-bit) and are quieter. The threshold must come down with the noise.
+    std::mt19937 rng(1);
+    static DetectionSettings settings = DEFAULT_DETECTION_SETTINGS;
+    FlameTriangulation flameSensor(settings);
+    hostSetMicros(0);
+    flameSensor.calibrate(AMBIENT, AMBIENT, AMBIENT);
+    int noisy = run(flameSensor, rng, AMBIENT, 40.0f, 4000);
+    int quiet = run(flameSensor, rng, AMBIENT + 100, 10.0f, 4000);
+    printf("ambient step: threshold %d before, %d after\n", noisy, quiet);
+    CHECK(quiet < noisy * 2 / 3);
+}
+
+static void testUnbiasedSigma() {
+    // Thresholds at 3 and 6 sigma on the same noise: censoring at half the
+    // threshold would cut at 1.5 sigma and shrink the first
+    int thresholds[2];
+    for (int i = 0; i < 2; i++) {
+        std::mt19937 rng(2);
+        static DetectionSettings settings[2] = { DEFAULT_DETECTION_SETTINGS, DEFAULT_DETECTION_SETTINGS };
+        settings[i].noiseMultiplier = i == 0 ? 3.0f : 6.0f;
+        FlameTriangulation flameSensor(settings[i]);
+        hostSetMicros(0);
+        flameSensor.calibrate(AMBIENT, AMBIENT, AMBIENT);
+        thresholds[i] = run(flameSensor, rng, AMBIENT, 60.0f, 4000);
+    }
+    printf("k = 3: threshold %d, k = 6: threshold %d\n", thresholds[0], thresholds[1]);
+    CHECK(thresholds[0] * 2 >= thresholds[1] * 9 / 10);
+    CHECK(thresholds[0] * 2 <= thresholds[1] * 11 / 10);
+}
+
+int main() {
+    testAmbientStep();
+    testUnbiasedSigma();
+    return checkResult("cfar_noise");
+}
@@ -0,0 +1,167 @@
+// CommandChannel: command parsing, replies and their pacing, EEPROM
+// round trips, and the refusals of a FIXED_SETTINGS build (built twice,
+// as test_command_channel and test_command_channel_fixed).
+
+#include "../host/Arduino.h"
+#include "../../include/CommandChannel.h"
+#include "../../include/ServoControl.h"
+#include "../../include/PumpControl.h"
+#include "../../include/LCDManager.h"
+#include "../../include/Log.h"
+#include "check.h"
+
+#include <string>
+
+static const Settings defaults PROGMEM = {
+    DEFAULT_SERVO_SETTINGS, DEFAULT_PUMP_SETTINGS, DEFAULT_DETECTION_SETTINGS, DEFAULT_DISPLAY_SETTINGS
+};
+
+static Settings settings;
+static SettingsRegistry registry(settings, &defaults);
+static BlackBox blackBox;
+static IncidentTimeline timeline;
+static CommandChannel channel(registry, blackBox, timeline);
+
+// Sends text and polls, with an emptied transmit buffer each time, until
+// it is all read and answered (a listing starts on the poll after the
+// command); returns what was printed
+static std::string send(const char* text, bool* changed = nullptr) {
+    hostSerialInput(text);
+    std::string output;
+    bool result = false;
+    int quietPolls = 0;
+    while (quietPolls < 2) {
+        hostSetSerialRoom(LOG_LINE_SIZE);
+        result |= channel.poll();
+        std::string printed = hostSerialTake();
+        quietPolls = printed.empty() && Serial.available() == 0 ? quietPolls + 1 : 0;
+        output += printed;
+    }
+    if (changed) *changed = result;
+    return output;
+}
+
+#define CHECK_REPLY(expected, actual)                                                    \
+    do {                                                                                 \
+        std::string actual_ = (actual);                                                  \
+        if (actual_ != (expected)) {                                                     \
+            fprintf(stderr, "%s:%d: reply \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+                    actual_.c_str(), std::string(expected).c_str());                     \
+            checkFailures++;                                                             \
+        }                                                                                \
+    } while (0)
+
+static int countLines(const std::string& text) {
+    int lines = 0;
+    for (char c : text) lines += c == '\n';
+    return lines;
+}
+
+static void testGet() {
+    CHECK_REPLY("scan_delay = 30\r\n", send("get scan_delay\n"));
+    // Tabs, repeated spaces and CR LF line ends
+    CHECK_REPLY("tracking_speed = 0.100\r\n", send("  get\t tracking_speed \r\n"));
+    CHECK_REPLY("error: unknown setting\r\n", send("get scan\n"));
+    // Empty lines are ignored
+    CHECK_REPLY("", send("\r\n\n"));
+    std::string all = send("get\n");
+    CHECK_EQUAL(registry.count(), countLines(all));
+    CHECK(all.compare(0, 12, "scan_step = ") == 0);
+}
+
+static void testPacing() {
+    // Nothing is read while a reply might not fit
+    hostSerialInput("get pulse_ms\n");
+    hostSetSerialRoom(LOG_LINE_SIZE - 1);
+    channel.poll();
+    CHECK_REPLY("", hostSerialTake());
+    CHECK_EQUAL(13, Serial.available());
+    CHECK_REPLY("pulse_ms = 1000\r\n", send(""));
+
+    // The listing starts on the next poll and goes out a line per poll while
+    // there is room for one line at a time; the next command waits for it
+    hostSerialInput("get\nget noise_k\n");
+    hostSetSerialRoom(LOG_LINE_SIZE);
+    channel.poll();
+    CHECK_REPLY("", hostSerialTake());
+    for (int i = 0; i < registry.count(); i++) {
+        hostSetSerialRoom(LOG_LINE_SIZE);
+        channel.poll();
+        CHECK_EQUAL(1, countLines(hostSerialTake()));
+    }
+    CHECK_EQUAL(12, Serial.available());
+    CHECK_REPLY("noise_k = 6.000\r\n", send(""));
+}
+
+static void testLongLine() {
+    CHECK_REPLY("error: line too long\r\n", send("get 0123456789012345678901234567890123456789\n"));
+    // The next line is read normally
+    CHECK_REPLY("scan_delay = 30\r\n", send("get scan_delay\n"));
+}
+
+static void testUnknown() {
+    CHECK_REPLY("commands: get, set, save, load, defaults, dump, rearm, kpi\r\n", send("help\n"));
+    CHECK_REPLY("ok: incident statistics cleared\r\n", send("kpi clear\n"));
+    CHECK_REPLY("ok: black box rearmed\r\n", send("rearm\n"));
+}
+
+#ifndef FIXED_SETTINGS
+static void testSet() {
+    bool changed = false;
+    CHECK_REPLY("scan_step = 4\r\n", send("set scan_step 4\n", &changed));
+    CHECK(changed);
+    CHECK_EQUAL(4, settings.servo.scanStep);
+    // Integers are rounded, floats kept
+    CHECK_REPLY("settle_ms = 1501\r\n", send("set settle_ms 1500.6\n"));
+    CHECK_REPLY("pump_angle = 12.500\r\n", send("set pump_angle 12.5\n"));
+
+    CHECK_REPLY("error: out of range\r\n", send("set scan_step 11\n", &changed));
+    CHECK(!changed);
+    CHECK_REPLY("error: out of range\r\n", send("set noise_k -1\n"));
+    CHECK_REPLY("error: not a number\r\n", send("set scan_step 4x\n"));
+    CHECK_REPLY("error: unknown setting\r\n", send("set scan 4\n"));
+    CHECK_REPLY("usage: set <name> <value>\r\n", send("set scan_step\n"));
+    CHECK_EQUAL(4, settings.servo.scanStep);
+}
+
+static void testStorage() {
+    registry.restoreDefaults();
+    CHECK_REPLY("error: no saved settings, defaults restored\r\n", send("load\n"));
+    send("set pulse_ms 2500\n");
+    CHECK_REPLY("ok: saved\r\n", send("save\n"));
+    send("set pulse_ms 300\n");
+    bool changed = false;
+    CHECK_REPLY("ok: loaded\r\n", send("load\n", &changed));
+    CHECK(changed);
+    CHECK_EQUAL(2500, settings.pump.pulseDuration);
+    CHECK_REPLY("ok: defaults restored\r\n", send("defaults\n"));
+    CHECK_EQUAL(DEFAULT_PULSE_DURATION, settings.pump.pulseDuration);
+}
+#else
+static void testFixed() {
+    const char* commands[] = { "set scan_step 4\n", "save\n", "load\n", "defaults\n" };
+    for (const char* command : commands) {
+        bool changed = true;
+        CHECK_REPLY("error: settings are fixed in this build\r\n", send(command, &changed));
+        CHECK(!changed);
+    }
+    CHECK_EQUAL(DEFAULT_SCAN_STEP, settings.servo.scanStep);
+}
+#endif
+
+int main() {
+    hostSerialCapture(true);
+    registry.restoreDefaults();
+    testGet();
+    testPacing();
+    testLongLine();
+    testUnknown();
+#ifndef FIXED_SETTINGS
+    testSet();
+    testStorage();
+    return checkResult("command_channel");
+#else
+    testFixed();
+    return checkResult("command_channel_fixed");
+#endif
+}
@@ -0,0 +1,80 @@
+// Automatic re-baselining (FlameTriangulation::updateCalibrationMonitoring)
+// follows slow ambient drift, but not so far that a slowly growing flame
+// is absorbed into the baseline.
+
+#include "../host/Arduino.h"
+#include "../../include/FlameTriangulation.h"
+#include "check.h"
+
+#define FRAME_MICROS 5000L
+#define CHECK_INTERVAL_MS 5000L    // AmbientMonitor's interval in main.cpp
+#define AMBIENT 3000
+#define COUNTS_10BIT (1 << ADC_OVERSAMPLE_BITS)
+
+struct Run {
+    long detectedFrames;
+    long firstDetectionMs;
+    bool calibrationNeeded;
+    int baseline;                  // Channel 0 at the end
+};
+
+// Ambient changing by rate 10-bit counts per second for seconds, with a
+// count of noise, on the real detector and its 5 s monitoring
+static Run ramp(float rate, long seconds) {
+    FlameTriangulation flameSensor(DEFAULT_DETECTION_SETTINGS);
+    hostSetMicros(0);
+    flameSensor.calibrate(AMBIENT, AMBIENT, AMBIENT);
+    Run run = { 0, -1, false, 0 };
+    long frames = seconds * 1000000L / FRAME_MICROS;
+    for (long f = 0; f < frames; f++) {
+        hostAdvanceMicros(FRAME_MICROS);
+        long ms = f * FRAME_MICROS / 1000;
+        int level = AMBIENT + (int)lroundf(rate * COUNTS_10BIT * ms / 1000.0f);
+        int n = (int)(f % 3) - 1;
+        flameSensor.updateReadings(level + n, level - n, level + n);
+        if (flameSensor.isFlameDetected()) {
+            if (run.firstDetectionMs < 0) run.firstDetectionMs = ms;
+            run.detectedFrames++;
+        }
+        if (f % (CHECK_INTERVAL_MS * 1000 / FRAME_MICROS) == 0) {
+            flameSensor.updateCalibrationMonitoring();
+            run.calibrationNeeded |= flameSensor.calibrationNeeded;
+        }
+    }
+    run.baseline = flameSensor.ambientLevel1;
+    return run;
+}
+
+static void testGrowingFlame() {
+    // Readings falling 0.5 counts/s for 10 min: 300 counts, a large flame
+    Run run = ramp(-0.5f, 600);
+    CHECK(run.detectedFrames > 0);
+    CHECK(run.firstDetectionMs >= 0 && run.firstDetectionMs < 200000L);
+    CHECK(run.calibrationNeeded);
+    CHECK(AMBIENT - run.baseline <= DRIFT_WARNING_COUNTS * COUNTS_10BIT / 2);
+    printf("growing flame: detected after %ld s, baseline %d -> %d\n", run.firstDetectionMs / 1000, AMBIENT,
+           run.baseline);
+}
+
+static void testDimmingRoom() {
+    // Readings rising (less IR) 0.1 counts/s for 10 min are followed
+    Run run = ramp(0.1f, 600);
+    CHECK_EQUAL(0, run.detectedFrames);
+    CHECK(!run.calibrationNeeded);
+    CHECK(run.baseline - AMBIENT >= 50 * COUNTS_10BIT);
+}
+
+static void testBrighteningRoom() {
+    // A small move towards more IR is still followed without an alarm
+    Run run = ramp(-0.05f, 600);
+    CHECK_EQUAL(0, run.detectedFrames);
+    CHECK(!run.calibrationNeeded);
+    CHECK(AMBIENT - run.baseline >= 20 * COUNTS_10BIT);
+}
+
+int main() {
+    testGrowingFlame();
+    testDimmingRoom();
+    testBrighteningRoom();
+    return checkResult("drift_follow");
+}
@@ -0,0 +1,100 @@
+// FlameTargetList: merging peaks of one flame, replacement when full,
+// expiry and the serviced rounds.
+
+#include "../host/Arduino.h"
+#include "../../include/FlameTargets.h"
+#include "check.h"
+
+static void testMerge() {
+    FlameTargetList targets;
+    hostSetMicros(0);
+    targets.observe(60, 1.0f);
+    // Within TARGET_MERGE_DEGREES: the same flame; the stronger peak moves it
+    targets.observe(60 + TARGET_MERGE_DEGREES, 1.5f);
+    CHECK_EQUAL(1, targets.count());
+    CHECK_EQUAL(60 + TARGET_MERGE_DEGREES, targets.get(0).bearing);
+    // A weaker observation on the flank only refreshes it
+    targets.observe(65, 0.5f);
+    CHECK_EQUAL(1, targets.count());
+    CHECK_EQUAL(70, targets.get(0).bearing);
+    CHECK(targets.get(0).strength == 1.5f);
+
+    // Further out: a second flame
+    targets.observe(70 + TARGET_MERGE_DEGREES + 1, 1.0f);
+    CHECK_EQUAL(2, targets.count());
+    CHECK_EQUAL(0, targets.find(72));
+    CHECK_EQUAL(1, targets.find(80));
+    CHECK_EQUAL(-1, targets.find(100));
+}
+
+static void testRefinedBearingFoldsNeighbour() {
+    // Two entries opened on the flanks of one flame: when the peak lands
+    // between them within reach of both, they become one
+    FlameTargetList targets;
+    hostSetMicros(0);
+    targets.observe(50, 0.4f);
+    targets.observe(66, 0.4f);
+    CHECK_EQUAL(2, targets.count());
+    targets.markServiced(1);
+    targets.observe(58, 2.0f);
+    CHECK_EQUAL(1, targets.count());
+    CHECK_EQUAL(58, targets.get(0).bearing);
+    // Not serviced: only one of the merged entries was
+    CHECK(!targets.get(0).serviced);
+}
+
+static void testFullList() {
+    FlameTargetList targets;
+    hostSetMicros(0);
+    for (int i = 0; i < MAX_FLAME_TARGETS; i++) targets.observe(20 + 30 * i, 1.0f + i);
+    CHECK_EQUAL(MAX_FLAME_TARGETS, targets.count());
+    // A weaker new peak is ignored; a stronger one replaces the weakest
+    targets.observe(160, 0.5f);
+    CHECK_EQUAL(-1, targets.find(160));
+    targets.observe(160, 3.0f);
+    CHECK_EQUAL(MAX_FLAME_TARGETS, targets.count());
+    CHECK(targets.find(160) >= 0);
+    CHECK_EQUAL(-1, targets.find(20));
+}
+
+static void testExpiry() {
+    FlameTargetList targets;
+    hostSetMicros(0);
+    targets.observe(40, 1.0f);
+    targets.observe(120, 1.0f);
+    hostSetMicros(15000000UL);
+    targets.touch(118);      // Seen again on its bearing
+    hostSetMicros((TARGET_TIMEOUT + 1) * 1000UL);
+    targets.expire(TARGET_TIMEOUT);
+    CHECK_EQUAL(1, targets.count());
+    CHECK_EQUAL(120, targets.get(0).bearing);
+}
+
+static void testRounds() {
+    FlameTargetList targets;
+    hostSetMicros(0);
+    targets.observe(30, 1.0f);
+    targets.observe(90, 3.0f);
+    targets.observe(150, 2.0f);
+    // Strongest first, then the next strongest not yet serviced
+    int first = targets.highestPriority();
+    CHECK_EQUAL(90, targets.get(first).bearing);
+    targets.markServiced(first);
+    CHECK_EQUAL(150, targets.get(targets.highestPriority()).bearing);
+    targets.markServiced(targets.highestPriority());
+    CHECK_EQUAL(30, targets.get(targets.highestPriority()).bearing);
+    targets.markServiced(targets.highestPriority());
+    // Every target had its turn: a new round starts with the strongest
+    CHECK_EQUAL(90, targets.get(targets.highestPriority()).bearing);
+    targets.clear();
+    CHECK_EQUAL(-1, targets.highestPriority());
+}
+
+int main() {
+    testMerge();
+    testRefinedBearingFoldsNeighbour();
+    testFullList();
+    testExpiry();
+    testRounds();
+    return checkResult("flame_targets");
+}
@@ -0,0 +1,63 @@
+// PumpControl water budget: the relay's on-time in any window stays within
+// PUMP_BURST_BUDGET plus PUMP_DUTY_PERCENT of the window, idle time does
+// not bank more than one burst, and the budget is actually used.
+
+#include "../host/Arduino.h"
+#include "../../include/PumpControl.h"
+#include "check.h"
+
+#include <vector>
+
+#define FLAME_MS 120000L
+#define IDLE_MS 600000L
+
+// Relay on-time per millisecond: a steady flame the pump never puts out
+// (each pulse looks ineffective, so pulses grow to their maximum), a long
+// flame-free pause, then the flame again
+static std::vector<long> runSchedule() {
+    PumpControl pump(DEFAULT_PUMP_SETTINGS);
+    hostSetMicros(0);
+    pump.begin();
+    std::vector<long> onTime(1, 0);
+    for (long ms = 0; ms < 2 * FLAME_MS + IDLE_MS; ms++) {
+        hostSetMicros(ms * 1000);
+        bool flame = ms < FLAME_MS || ms >= FLAME_MS + IDLE_MS;
+        pump.update(flame, 90, 90, flame ? 2.0f : 0.0f, flame ? 1.0f : 0.0f);
+        onTime.push_back(onTime.back() + (pump.isPumpActive() ? 1 : 0));
+    }
+    return onTime;
+}
+
+static long allowed(long length) {
+    return PUMP_BURST_BUDGET + length * PUMP_DUTY_PERCENT / 100;
+}
+
+int main() {
+    std::vector<long> onTime = runSchedule();
+    long end = onTime.size() - 1;
+
+    // Every window from 1 s to 120 s, starting every 100 ms. One
+    // millisecond of slack: the relay opens on the update that finds the
+    // bucket empty.
+    long worstExcess = -end;
+    for (long start = 0; start < end; start += 100) {
+        for (long length = 1000; length <= FLAME_MS && start + length <= end; length += 1000) {
+            worstExcess = max(worstExcess, onTime[start + length] - onTime[start] - allowed(length));
+        }
+    }
+    CHECK(worstExcess <= 1);
+
+    // The pause refills the bucket but no further: the flame's return gets
+    // the same water as the first start with a full bucket
+    long second = FLAME_MS + IDLE_MS;
+    CHECK_EQUAL(0, onTime[second] - onTime[FLAME_MS]);
+    for (long length = 5000; length <= 30000; length += 5000) {
+        CHECK(onTime[second + length] - onTime[second] <= allowed(length) + 1);
+    }
+
+    // The budget is used, not just respected: the long-run duty comes
+    // close to the limit
+    CHECK(onTime[FLAME_MS] >= FLAME_MS * PUMP_DUTY_PERCENT / 100 * 9 / 10);
+    CHECK(onTime[end] - onTime[second] >= FLAME_MS * PUMP_DUTY_PERCENT / 100 * 9 / 10);
+    return checkResult("pump_budget");
+}
@@ -0,0 +1,136 @@
+// RawCapture encoder against the capture_decode frame decoder: CRC, delta
+// widths, exact round trips and sequence numbers across ring overruns.
+
+#include "../host/Arduino.h"
+#include "../../include/RawCapture.h"
+#include "../capture.h"
+#include "check.h"
+
+#include <vector>
+
+struct ByteSink : public Print {
+    std::vector<uint8_t> bytes;
+    size_t write(uint8_t value) { bytes.push_back(value); return 1; }
+    using Print::write;
+};
+
+// Decodes every frame in the sink into samples; returns the frame count
+static int decodeAll(const ByteSink& sink, std::vector<uint16_t>& indices, std::vector<CaptureFrame>& frames) {
+    size_t pos = 0;
+    while (pos < sink.bytes.size()) {
+        CaptureFrame frame;
+        if (decodeCaptureFrame(&sink.bytes[pos], sink.bytes.size() - pos, frame) != CAPTURE_FRAME) return -1;
+        indices.push_back(frame.index);
+        frames.push_back(frame);
+        pos += frame.length;
+    }
+    return (int)frames.size();
+}
+
+static void testCrc() {
+    // Standard check value of CRC-8 (polynomial 0x07, initial value 0)
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    CHECK_EQUAL(0xF4, captureCrc8(check, sizeof(check)));
+    CHECK_EQUAL(0, captureCrc8(check, 0));
+}
+
+static void testConstantFrame() {
+    RawCapture capture;
+    ByteSink sink;
+    capture.start();
+    for (int n = 0; n < CAPTURE_FRAME_SAMPLES; n++) capture.push(512, 0, 1023);
+    CHECK_EQUAL(1, capture.flush(sink));
+
+    // No deltas to send: header, 30 bits of first sample, CRC
+    CHECK_EQUAL(CAPTURE_FRAME_HEADER + 4 + 1, sink.bytes.size());
+    CaptureFrame frame;
+    CHECK_EQUAL(CAPTURE_FRAME, decodeCaptureFrame(sink.bytes.data(), sink.bytes.size(), frame));
+    CHECK_EQUAL(0, frame.width);
+    CHECK_EQUAL(CAPTURE_FRAME_SAMPLES, frame.count);
+    CHECK_EQUAL(512, frame.samples[CAPTURE_FRAME_SAMPLES - 1][0]);
+    CHECK_EQUAL(0, frame.samples[CAPTURE_FRAME_SAMPLES - 1][1]);
+    CHECK_EQUAL(1023, frame.samples[CAPTURE_FRAME_SAMPLES - 1][2]);
+}
+
+static void testRoundTrip() {
+    // Small deltas, then the full-scale swing that needs 11 bits
+    const int swings[] = { 3, 1023 };
+    const int widths[] = { 3, 11 };
+    for (int t = 0; t < 2; t++) {
+        RawCapture capture;
+        ByteSink sink;
+        capture.start();
+        uint16_t sent[CAPTURE_FRAME_SAMPLES][3];
+        for (int n = 0; n < CAPTURE_FRAME_SAMPLES; n++) {
+            sent[n][0] = (n & 1) ? swings[t] : 0;
+            sent[n][1] = 1023 - sent[n][0];
+            sent[n][2] = 500 + (n % 3) - 1;
+            capture.push(sent[n][0], sent[n][1], sent[n][2]);
+        }
+        CHECK_EQUAL(1, capture.flush(sink));
+        CaptureFrame frame;
+        CHECK_EQUAL(CAPTURE_FRAME, decodeCaptureFrame(sink.bytes.data(), sink.bytes.size(), frame));
+        CHECK_EQUAL(widths[t], frame.width);
+        CHECK_EQUAL(sink.bytes.size(), frame.length);
+        for (int n = 0; n < CAPTURE_FRAME_SAMPLES; n++) {
+            for (int c = 0; c < 3; c++) CHECK_EQUAL(sent[n][c], frame.samples[n][c]);
+        }
+    }
+}
+
+static void testOverrunGap() {
+    RawCapture capture;
+    ByteSink sink;
+    capture.start();
+    // The ring holds CAPTURE_BUFFER_SIZE - 1 entries; the next 5 are lost
+    int pushed = 0;
+    for (; pushed < CAPTURE_BUFFER_SIZE - 1 + 5; pushed++) capture.push(pushed, pushed, pushed);
+    CHECK_EQUAL(5, capture.getLostCount());
+    // One full frame goes out; the rest waits for a full frame
+    CHECK_EQUAL(1, capture.flush(sink));
+    // The gap marker goes in with the next sample and ends the pending frame
+    capture.push(pushed, 0, 0);
+    pushed++;
+    CHECK_EQUAL(1, capture.flush(sink));
+    for (int n = 1; n < CAPTURE_FRAME_SAMPLES; n++, pushed++) capture.push(pushed, 0, 0);
+    CHECK_EQUAL(1, capture.flush(sink));
+
+    std::vector<uint16_t> indices;
+    std::vector<CaptureFrame> frames;
+    CHECK_EQUAL(3, decodeAll(sink, indices, frames));
+    if (frames.size() != 3) return;
+    CHECK_EQUAL(0, indices[0]);
+    CHECK_EQUAL(CAPTURE_FRAME_SAMPLES, indices[1]);
+    CHECK_EQUAL(CAPTURE_BUFFER_SIZE - 1 - CAPTURE_FRAME_SAMPLES, frames[1].count);
+    // The decoder sees the loss as a jump in the sequence numbers
+    CHECK_EQUAL(CAPTURE_BUFFER_SIZE - 1 + 5, indices[2]);
+    CHECK_EQUAL(CAPTURE_BUFFER_SIZE - 1 + 5, frames[2].samples[0][0]);
+}
+
+static void testDamage() {
+    RawCapture capture;
+    ByteSink sink;
+    capture.start();
+    for (int n = 0; n < CAPTURE_FRAME_SAMPLES; n++) capture.push(n * 7, n * 3, 900 - n);
+    capture.flush(sink);
+    CaptureFrame frame;
+    CHECK_EQUAL(CAPTURE_TRUNCATED, decodeCaptureFrame(sink.bytes.data(), sink.bytes.size() - 1, frame));
+    for (size_t i = 2; i < sink.bytes.size(); i++) {
+        std::vector<uint8_t> damaged = sink.bytes;
+        damaged[i] ^= 0x10;
+        CaptureResult result = decodeCaptureFrame(damaged.data(), damaged.size(), frame);
+        // A damaged count or width may also make the header impossible or too long
+        CHECK(result != CAPTURE_FRAME);
+    }
+    const uint8_t text[] = "Flame detected\r\n";
+    CHECK_EQUAL(CAPTURE_NO_FRAME, decodeCaptureFrame(text, sizeof(text) - 1, frame));
+}
+
+int main() {
+    testCrc();
+    testConstantFrame();
+    testRoundTrip();
+    testOverrunGap();
+    testDamage();
+    return checkResult("raw_capture");
+}
@@ -0,0 +1,100 @@
+// SampleAligner: interpolation of the later channels back to the earliest
+// one, across the wrap of the 16-bit stamps, on every frame the loop reads
+// however many it missed, and none on the first frame after a restart.
+
+#include "../host/Arduino.h"
+#include "../../include/SampleAligner.h"
+#include "check.h"
+
+#define FRAME_MICROS 5000UL
+#define CHANNEL_MICROS 110UL       // Conversion time plus interrupt latency
+
+// A light level rising by one count every 10 us
+static int ramp(unsigned long t) { return 1000 + (int)(t / 10); }
+
+// The frame whose channel 0 is captured at t, with the one the sampler
+// converted before it; the channels follow a conversion apart, or in the
+// order given
+static SampleTriple frameAt(unsigned long t, const uint8_t order[3], bool hasPrevious = true) {
+    SampleTriple triple;
+    for (uint8_t ch = 0; ch < ADC_SAMPLER_CHANNELS; ch++) {
+        unsigned long captured = t + order[ch] * CHANNEL_MICROS;
+        triple.reading[ch] = ramp(captured);
+        triple.stamp[ch] = (uint16_t)captured;
+        triple.previous[ch] = ramp(captured - FRAME_MICROS);
+        triple.previousStamp[ch] = (uint16_t)(captured - FRAME_MICROS);
+    }
+    triple.hasPrevious = hasPrevious;
+    return triple;
+}
+
+static const uint8_t inTurn[3] = { 0, 1, 2 };
+
+static void align(SampleAligner& aligner, const SampleTriple& triple, int aligned[3]) {
+    aligner.align(triple, aligned[0], aligned[1], aligned[2]);
+}
+
+static void testFirstFrame() {
+    // Straight after begin() the sampler has no previous frame
+    SampleAligner aligner;
+    SampleTriple triple = frameAt(1000, inTurn, false);
+    int aligned[3];
+    align(aligner, triple, aligned);
+    for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[ch], aligned[ch]);
+}
+
+static void testAcrossStampWrap() {
+    // Frames whose stamps run through 65535 to 0, including one where the
+    // wrap falls between its channels and one where it falls between a
+    // channel and its previous frame
+    SampleAligner aligner;
+    int aligned[3];
+    unsigned long t = 65536UL - 3 * FRAME_MICROS - 2 * CHANNEL_MICROS + 40;
+    for (int frame = 0; frame < 6; frame++) {
+        t += FRAME_MICROS;
+        SampleTriple triple = frameAt(t, inTurn);
+        align(aligner, triple, aligned);
+        // The ramp is a straight line, so every channel lands on channel 0
+        for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[0], aligned[ch]);
+    }
+
+    // The earliest channel need not be the first
+    const uint8_t order[3] = { 2, 0, 1 };
+    t += FRAME_MICROS;
+    SampleTriple triple = frameAt(t, order);
+    align(aligner, triple, aligned);
+    for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[1], aligned[ch]);
+}
+
+static void testMissedFrames() {
+    // The loop reads one frame in several; each still comes with the frame
+    // converted just before it and is aligned on its own
+    SampleAligner aligner;
+    int aligned[3];
+    unsigned long t = 20000;
+    align(aligner, frameAt(t, inTurn), aligned);
+    for (int gap = 2; gap <= 14; gap += 3) {
+        t += gap * FRAME_MICROS;
+        SampleTriple triple = frameAt(t, inTurn);
+        align(aligner, triple, aligned);
+        for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[0], aligned[ch]);
+    }
+
+    // A restart leaves the first frame after it as read, and the frame
+    // after that is interpolated again
+    t += FRAME_MICROS;
+    SampleTriple triple = frameAt(t, inTurn, false);
+    align(aligner, triple, aligned);
+    for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[ch], aligned[ch]);
+    t += FRAME_MICROS;
+    triple = frameAt(t, inTurn);
+    align(aligner, triple, aligned);
+    for (int ch = 0; ch < 3; ch++) CHECK_EQUAL(triple.reading[0], aligned[ch]);
+}
+
+int main() {
+    testFirstFrame();
+    testAcrossStampWrap();
+    testMissedFrames();
+    return checkResult("sample_aligner");
+}
@@ -0,0 +1,76 @@
+// SensorHealth on the real FlameTriangulation: a flame that saturates
+// every sensor stays detected, and channels that are all faulty are kept
+// in use rather than leaving the detector blind.
+
+#include "../host/Arduino.h"
+#include "../../include/SensorHealth.h"
+#include "check.h"
+
+#define FRAME_MICROS 5000L
+#define AMBIENT (3000 + (1 << ADC_OVERSAMPLE_BITS) * 2)
+
+static FlameTriangulation flameSensor(DEFAULT_DETECTION_SETTINGS);
+static SensorHealth sensorHealth;
+
+static void calibrate() {
+    hostSetMicros(0);
+    flameSensor.calibrate(AMBIENT, AMBIENT, AMBIENT);
+    flameSensor.setChannelMask(ALL_SENSORS_MASK);
+    sensorHealth.reset();
+}
+
+#define LIVE ALL_SENSORS_MASK
+#define FROZEN 0
+
+// A count of noise on the channels in live, as a live sensor shows
+static void frame(int reading1, int reading2, int reading3, uint8_t live) {
+    static int wobble = 0;
+    int n = (++wobble % 3) - 1;
+    hostAdvanceMicros(FRAME_MICROS);
+    flameSensor.updateReadings(reading1 + (live & 1 ? n : 0), reading2 - (live & 2 ? n : 0),
+                               reading3 + (live & 4 ? n : 0));
+    sensorHealth.update(flameSensor);
+}
+
+static void testSaturatingFlame() {
+    calibrate();
+    for (int f = 0; f < 1000; f++) frame(AMBIENT, AMBIENT, AMBIENT, LIVE);
+    // A large fire straight ahead pins all three sensors at 0 for a minute
+    long missed = 0;
+    for (long f = 0; f < 60000000L / FRAME_MICROS; f++) {
+        frame(0, 0, 0, FROZEN);
+        if (f >= 100 && !flameSensor.isFlameDetected()) missed++;
+    }
+    CHECK_EQUAL(0, missed);
+    CHECK_EQUAL(ALL_SENSORS_MASK, flameSensor.getChannelMask());
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) CHECK_EQUAL(0, sensorHealth.getFaults(c) & SENSOR_FAULT_FLAT);
+}
+
+static void testAllFaulty() {
+    calibrate();
+    for (int f = 0; f < 1000; f++) frame(AMBIENT, AMBIENT, AMBIENT, LIVE);
+    // Disconnected inputs float at one value and never move
+    for (long f = 0; f < 20000000L / FRAME_MICROS; f++) frame(AMBIENT, AMBIENT, AMBIENT, FROZEN);
+    for (uint8_t c = 0; c < SENSOR_COUNT; c++) CHECK(sensorHealth.getFaults(c) & SENSOR_FAULT_FLAT);
+    CHECK(sensorHealth.isDegraded());
+    CHECK_EQUAL(ALL_SENSORS_MASK, flameSensor.getChannelMask());
+    // A flame is still seen
+    for (int f = 0; f < 200; f++) frame(AMBIENT - 600, AMBIENT - 600, AMBIENT - 600, LIVE);
+    CHECK(flameSensor.isFlameDetected());
+}
+
+static void testOneFrozenChannel() {
+    calibrate();
+    for (int f = 0; f < 1000; f++) frame(AMBIENT, AMBIENT, AMBIENT, LIVE);
+    // The middle sensor freezes; the others stay live
+    for (long f = 0; f < 20000000L / FRAME_MICROS; f++) frame(AMBIENT, AMBIENT, AMBIENT, 0x03);
+    CHECK_EQUAL(SENSOR_FAULT_FLAT, sensorHealth.getFaults(2));
+    CHECK_EQUAL(0x03, flameSensor.getChannelMask());
+}
+
+int main() {
+    testSaturatingFlame();
+    testAllFaulty();
+    testOneFrozenChannel();
+    return checkResult("sensor_health");
+}
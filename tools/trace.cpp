@@ -0,0 +1,21 @@
+#include "trace.h"
+
+#include <stdio.h>
+
+bool loadTrace(const char* path, std::vector<TraceSample>& samples) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        int a0, a1, a2;
+        if (sscanf(line, "%d %d %d", &a0, &a1, &a2) != 3) continue;
+        TraceSample s;
+        s.reading[0] = a2; // SENSOR1_PIN, right
+        s.reading[1] = a0; // SENSOR2_PIN, left
+        s.reading[2] = a1; // SENSOR3_PIN, middle
+        samples.push_back(s);
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,16 @@
+// Raw sensor trace loading shared by the host tools.
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <vector>
+
+// One raw sample triple in firmware sensor order: right (A2), left (A0), middle (A1)
+struct TraceSample {
+    int reading[3];
+};
+
+// Text trace: "A0 A1 A2" per line as printed by examples/Sensor_Debugging.ino,
+// '#' starts a comment line
+bool loadTrace(const char* path, std::vector<TraceSample>& samples);
+
+#endif // TRACE_H